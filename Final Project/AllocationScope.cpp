@@ -0,0 +1,27 @@
+#include "AllocationScope.h"
+#include <algorithm>
+
+namespace {
+thread_local AllocationScope* currentScope = nullptr;
+}
+
+AllocationScope::AllocationScope() : outer(currentScope) {
+    currentScope = this;
+}
+
+AllocationScope::~AllocationScope() {
+    currentScope = outer;
+}
+
+void AllocationScope::allocated(size_t bytes) {
+    for (AllocationScope* scope = currentScope; scope; scope = scope->outer) {
+        scope->live += static_cast<long long>(bytes);
+        scope->peak = std::max(scope->peak, scope->live);
+    }
+}
+
+void AllocationScope::released(size_t bytes) {
+    for (AllocationScope* scope = currentScope; scope; scope = scope->outer) {
+        scope->live -= static_cast<long long>(bytes);
+    }
+}
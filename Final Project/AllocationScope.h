@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+
+// Measures the image memory a thread allocates while the scope is alive: the
+// peak of bytes allocated minus bytes freed since it opened. Node::evaluate()
+// wraps process() in one to find each node's transient high-water mark.
+//
+// Allocations are reported by PooledMatAllocator and ScratchFileAllocator, so
+// only buffers that go through them are seen; with the pool installed as the
+// default allocator that is every image-sized Mat. Work OpenCV hands to its own
+// threads inside a call is not attributed to the caller.
+class AllocationScope {
+public:
+    AllocationScope();
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    size_t peakBytes() const { return peak > 0 ? static_cast<size_t>(peak) : 0; }
+
+    // Called by the allocators on the thread that allocates or frees
+    static void allocated(size_t bytes);
+    static void released(size_t bytes);
+
+private:
+    AllocationScope* outer;  // scopes nest, each sees what the inner ones do
+    long long live = 0;
+    long long peak = 0;
+};
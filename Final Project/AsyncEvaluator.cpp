@@ -0,0 +1,58 @@
+#include "AsyncEvaluator.h"
+#include <iostream>
+
+AsyncEvaluator::AsyncEvaluator(GraphExecutor& executor)
+    : executor(executor), worker(&AsyncEvaluator::workerLoop, this) {}
+
+AsyncEvaluator::~AsyncEvaluator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void AsyncEvaluator::update(const std::vector<Node*>& nodes, const std::vector<Node*>& requested) {
+    // Planning reads the wiring and dirty flags, which belong to the UI thread.
+    // Edits made while a pass is running leave nodes dirty for the next one.
+    if (busy()) return;
+
+    GraphExecutor::Plan plan = executor.plan(nodes, requested);
+    if (plan.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = std::move(plan);
+        hasPending = true;
+        running = true;
+    }
+    wake.notify_one();
+}
+
+bool AsyncEvaluator::busy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return running;
+}
+
+void AsyncEvaluator::workerLoop() {
+    while (true) {
+        GraphExecutor::Plan plan;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || hasPending; });
+            if (stopping) return;
+            plan = std::move(pending);
+            hasPending = false;
+        }
+
+        try {
+            executor.run(plan);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error evaluating node graph: " << ex.what() << std::endl;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "GraphExecutor.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs graph evaluations on a background thread so that heavy nodes never block
+// the render loop. update() is called once per frame from the UI thread: when the
+// previous pass has finished and something is out of date, it plans the next pass
+// and hands it to the background thread. Nodes publish finished results through
+// their ResultSlot outputs and the UI uploads textures as new generations appear.
+//
+// Only one pass is ever in flight and the next one is planned from the latest
+// parameters, so intermediate slider values are never queued. Editing a node
+// while its pass runs cancels that node's job (see Node::markDirty), which lets
+// the pass wind down early and frees the CPU for the value on screen.
+class AsyncEvaluator {
+public:
+    explicit AsyncEvaluator(GraphExecutor& executor);
+    ~AsyncEvaluator();
+
+    AsyncEvaluator(const AsyncEvaluator&) = delete;
+    AsyncEvaluator& operator=(const AsyncEvaluator&) = delete;
+
+    // requested are the nodes whose results are wanted right now, see GraphExecutor
+    void update(const std::vector<Node*>& nodes, const std::vector<Node*>& requested);
+    void update(const std::vector<Node*>& nodes) { update(nodes, nodes); }
+    bool busy() const;
+
+private:
+    GraphExecutor& executor;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    GraphExecutor::Plan pending;
+    bool hasPending = false;
+    bool running = false;
+    bool stopping = false;
+
+    std::thread worker;  // declared last so it starts after the state above exists
+
+    void workerLoop();
+};
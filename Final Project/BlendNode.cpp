@@ -1,64 +1,76 @@
 #include "BlendNode.h"
-#include <imgui.h>
+#include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
-#include "tinyfiledialogs.h"
 
 BlendNode::BlendNode(int id) : Node(id, "Blend") {
     inputs.resize(1);  // One input from node system
-    secondImageTexture = 0;
-    texture = 0;
-    opacity = 1.0f;
-    blendMode = 0;
+}
+
+void BlendNode::paramsLoaded() {
+    // Graph files store the path; the pixels are read back from disk
+    if (params.secondImagePath.empty() || !loadSecondImage(params.secondImagePath)) {
+        params.secondImage = cv::Mat();
+        markDirty();
+    }
+}
+
+bool BlendNode::loadSecondImage(const std::string& path) {
+    cv::Mat image = cv::imread(path);
+    if (image.empty()) {
+        return false;
+    }
+    params.secondImagePath = path;
+    params.secondImage = image;
+    markDirty();
+    return true;
 }
 
 void BlendNode::process() {
-    if (inputs[0] && !secondImage.empty()) {
-        cv::Mat baseImage = inputs[0]->getOutput();
+    if (boundInputs[0] && !jobParams.secondImage.empty()) {
+        Frame baseFrame = takeInput(0);
         
-        if (!baseImage.empty()) {
+        if (!baseFrame.empty()) {
             cv::Mat resizedSecondImage;
-            if (baseImage.size() != secondImage.size()) {
-                cv::resize(secondImage, resizedSecondImage, baseImage.size());
+            if (baseFrame.size() != jobParams.secondImage.size()) {
+                cv::resize(jobParams.secondImage, resizedSecondImage, baseFrame.size());
             } else {
-                resizedSecondImage = secondImage;
+                resizedSecondImage = jobParams.secondImage;
             }
 
-            output = applyBlend(baseImage, resizedSecondImage, blendMode, opacity);
-
-            if (texture) {
-                glDeleteTextures(1, &texture);
-            }
-            texture = matToTexture(output);
+            cv::Mat result = applyBlend(std::move(baseFrame), resizedSecondImage, jobParams.blendMode, jobParams.opacity);
+            if (cancelled()) return;  // superseded by a newer edit
+            output.publish(Frame(std::move(result), jobScale));
         }
     }
-    dirty = false;
 }
 
-cv::Mat BlendNode::applyBlend(const cv::Mat& base, const cv::Mat& blend, int mode, float opacity) {
+cv::Mat BlendNode::applyBlend(Frame base, const cv::Mat& blend, int mode, float opacity) {
     cv::Mat result;
     switch (mode) {
         case 1: // Multiply
-            result = multiplyBlend(base, blend);
+            result = multiplyBlend(base.takeWritable(), blend);
             break;
         case 2: // Screen
-            result = screenBlend(base, blend);
+            result = screenBlend(base.takeWritable(), blend);
             break;
         case 3: // Overlay
-            result = overlayBlend(base, blend);
+            result = overlayBlend(base.takeWritable(), blend);
             break;
         case 4: // Difference
-            result = differenceBlend(base, blend);
+            result = differenceBlend(base.takeWritable(), blend);
             break;
         default: // Normal
-            cv::addWeighted(base, 1.0, blend, opacity, 0.0, result);
+            result = base.takeBuffer();  // the input itself if nothing else holds it
+            cv::addWeighted(result.empty() ? base.view() : ImageView(result), 1.0, blend, opacity, 0.0, result);
             break;
     }
     return result;
 }
 
-cv::Mat BlendNode::multiplyBlend(const cv::Mat& base, const cv::Mat& blend) {
-    cv::Mat result = base.clone();
+cv::Mat BlendNode::multiplyBlend(cv::Mat base, const cv::Mat& blend) {
+    cv::Mat& result = base;
     for (int i = 0; i < base.rows; i++) {
+        if (cancelled()) break;
         for (int j = 0; j < base.cols; j++) {
             for (int c = 0; c < 3; c++) {
                 float baseVal = base.at<cv::Vec3b>(i, j)[c] / 255.0f;
@@ -71,9 +83,10 @@ cv::Mat BlendNode::multiplyBlend(const cv::Mat& base, const cv::Mat& blend) {
     return result;
 }
 
-cv::Mat BlendNode::screenBlend(const cv::Mat& base, const cv::Mat& blend) {
-    cv::Mat result = base.clone();
+cv::Mat BlendNode::screenBlend(cv::Mat base, const cv::Mat& blend) {
+    cv::Mat& result = base;
     for (int i = 0; i < base.rows; i++) {
+        if (cancelled()) break;
         for (int j = 0; j < base.cols; j++) {
             for (int c = 0; c < 3; c++) {
                 float baseVal = base.at<cv::Vec3b>(i, j)[c] / 255.0f;
@@ -86,9 +99,10 @@ cv::Mat BlendNode::screenBlend(const cv::Mat& base, const cv::Mat& blend) {
     return result;
 }
 
-cv::Mat BlendNode::overlayBlend(const cv::Mat& base, const cv::Mat& blend) {
-    cv::Mat result = base.clone();
+cv::Mat BlendNode::overlayBlend(cv::Mat base, const cv::Mat& blend) {
+    cv::Mat& result = base;
     for (int i = 0; i < base.rows; i++) {
+        if (cancelled()) break;
         for (int j = 0; j < base.cols; j++) {
             for (int c = 0; c < 3; c++) {
                 float baseVal = base.at<cv::Vec3b>(i, j)[c] / 255.0f;
@@ -105,9 +119,10 @@ cv::Mat BlendNode::overlayBlend(const cv::Mat& base, const cv::Mat& blend) {
     return result;
 }
 
-cv::Mat BlendNode::differenceBlend(const cv::Mat& base, const cv::Mat& blend) {
-    cv::Mat result = base.clone();
+cv::Mat BlendNode::differenceBlend(cv::Mat base, const cv::Mat& blend) {
+    cv::Mat& result = base;
     for (int i = 0; i < base.rows; i++) {
+        if (cancelled()) break;
         for (int j = 0; j < base.cols; j++) {
             for (int c = 0; c < 3; c++) {
                 int diff = std::abs(base.at<cv::Vec3b>(i, j)[c] - blend.at<cv::Vec3b>(i, j)[c]);
@@ -118,115 +133,15 @@ cv::Mat BlendNode::differenceBlend(const cv::Mat& base, const cv::Mat& blend) {
     return result;
 }
 
-void BlendNode::drawUI() {
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
-    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
-    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
-    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom-right
-
-    // Gradient colors
-    ImVec4 color1 = ImVec4(85.0f / 255.0f, 0.0f / 255.0f, 40.0f / 255.0f, 1.0f);  
-    ImVec4 color2 = ImVec4(0.0f / 255.0f, 0.0f / 255.0f, 0.0f / 255.0f, 1.0f);
-
-    draw_list->AddRectFilledMultiColor(p0, p1,
-        ImColor(color1), ImColor(color1),  // top left to top right
-        ImColor(color2), ImColor(color2)); // bottom left to bottom right
-
-    // UI on top
-    ImGui::SetCursorScreenPos(p0);
-    // Input selection for node input
-    ImGui::Text("Input Image:");
-    if (ImGui::BeginCombo("Input##Blend", 
-        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
-        
-        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
-            setInput(0, nullptr);
-            markDirty();
-        }
-        
-        for (Node* node : Node::availableNodes) {
-            if (node != this) {
-                bool is_selected = (inputs[0] == node);
-                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
-                    setInput(0, node);
-                    markDirty();
-                }
-            }
-        }
-        ImGui::EndCombo();
-    }
-
-    // Second image loader
-    if (ImGui::Button("Load Second Image")) {
-        const char* filters[] = { "*.jpg", "*.png", "*.bmp" };
-        const char* selected = tinyfd_openFileDialog(
-            "Open Second Image",
-            "",
-            3,
-            filters,
-            "Image files",
-            0
-        );
-
-        if (selected) {
-            secondImagePath = selected;
-            secondImage = cv::imread(secondImagePath);
-            if (!secondImage.empty()) {
-                if (secondImageTexture) {
-                    glDeleteTextures(1, &secondImageTexture);
-                }
-                secondImageTexture = matToTexture(secondImage);
-                markDirty();
-            }
-        }
-    }
-
-    // Preview second image if loaded
-    if (secondImageTexture) {
-        ImGui::Text("Second Image:");
-        ImGui::Image((ImTextureID)(intptr_t)secondImageTexture, ImVec2(150, 150));
-    }
-
-    // Blend mode selection
-    const char* modes[] = { "Normal", "Multiply", "Screen", "Overlay", "Difference" };
-    if (ImGui::Combo("Blend Mode", &blendMode, modes, IM_ARRAYSIZE(modes))) {
-        markDirty();
-    }
-
-    // Opacity slider
-    if (ImGui::SliderFloat("Opacity", &opacity, 0.0f, 1.0f)) {
-        markDirty();
-    }
-
-    // Display result
-    if (texture) {
-        ImGui::Text("Result:");
-        ImGui::Image((ImTextureID)(intptr_t)texture, ImVec2(300, 300));
-    }
-}
-
-cv::Mat BlendNode::getOutput() const {
-    return output;
+Frame BlendNode::getOutput() const {
+    return output.read();
 }
 
-GLuint BlendNode::matToTexture(const cv::Mat& mat) {
-    cv::Mat rgbMat;
-    GLenum format;
-
-    if (mat.channels() == 3) {
-        cv::cvtColor(mat, rgbMat, cv::COLOR_BGR2RGB);
-        format = GL_RGB;
-    } else {
-        cv::cvtColor(mat, rgbMat, cv::COLOR_GRAY2RGB);
-        format = GL_RGB;
+size_t BlendNode::cacheBytes() const {
+    // The second image, plus the job's snapshot if a new one was loaded since
+    size_t bytes = params.secondImage.total() * params.secondImage.elemSize();
+    if (jobParams.secondImage.data != params.secondImage.data) {
+        bytes += jobParams.secondImage.total() * jobParams.secondImage.elemSize();
     }
-
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, rgbMat.cols, rgbMat.rows, 0, format, GL_UNSIGNED_BYTE, rgbMat.data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    return textureID;
+    return bytes;
 }
\ No newline at end of file
@@ -1,34 +1,57 @@
 #pragma once
 #include "Node.h"
-#include <GL/glew.h>
+#include "ResultSlot.h"
 
 class BlendNode : public Node {
 public:
+    // Blend parameters
+    struct Params {
+        float opacity = 1.0f;
+        int blendMode = 0;  // 0: Normal, 1: Multiply, 2: Screen, 3: Overlay, 4: Difference
+        std::string secondImagePath;
+        cv::Mat secondImage;  // For the directly loaded image
+
+        // The pixel pointer stands in for the image contents: a reload gets a new buffer
+        auto tie() const { return std::tie(opacity, blendMode, secondImagePath, secondImage.data); }
+        bool operator==(const Params& other) const { return tie() == other.tie(); }
+        size_t hash() const { return hashTuple(tie()); }
+        void visit(ParamVisitor& v) {
+            v.field("opacity", opacity);
+            v.field("blendMode", blendMode);
+            v.field("secondImagePath", secondImagePath);
+        }
+    };
+
     BlendNode(int id);
     void process() override;
-    cv::Mat getOutput() const override;
-    
-    void drawUI() override;
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return output.take(); }
+    size_t cacheBytes() const override;
+
+    size_t paramsHash() const override { return jobParams.hash(); }
+    const char* typeName() const override { return "BlendNode"; }
+    void visitParams(ParamVisitor& v) override { params.visit(v); }
+    void paramsLoaded() override;
 
+    Params params;  // edited by the UI
 
+    // Reads the image blended over the input; false if it cannot be loaded
+    bool loadSecondImage(const std::string& path);
+
+
+
+protected:
+    ResultSlot<Frame> output;
 
 private:
-    
-    cv::Mat output;
-    cv::Mat secondImage;  // For the directly loaded image
-    std::string secondImagePath;
-    GLuint texture = 0;
-    GLuint secondImageTexture = 0;  // Texture for preview of second image
-    
-    // Blend parameters
-    float opacity = 1.0f;
-    int blendMode = 0;  // 0: Normal, 1: Multiply, 2: Screen, 3: Overlay, 4: Difference
+    Params jobParams;  // snapshot read by process()
 
     // Methods
-    GLuint matToTexture(const cv::Mat& mat);
-    cv::Mat applyBlend(const cv::Mat& base, const cv::Mat& blend, int mode, float opacity);
-    cv::Mat multiplyBlend(const cv::Mat& base, const cv::Mat& blend);
-    cv::Mat screenBlend(const cv::Mat& base, const cv::Mat& blend);
-    cv::Mat overlayBlend(const cv::Mat& base, const cv::Mat& blend);
-    cv::Mat differenceBlend(const cv::Mat& base, const cv::Mat& blend);
+    void captureParams() override { jobParams = params; }
+    cv::Mat applyBlend(Frame base, const cv::Mat& blend, int mode, float opacity);
+    // Each blends into the base pixels it is given
+    cv::Mat multiplyBlend(cv::Mat base, const cv::Mat& blend);
+    cv::Mat screenBlend(cv::Mat base, const cv::Mat& blend);
+    cv::Mat overlayBlend(cv::Mat base, const cv::Mat& blend);
+    cv::Mat differenceBlend(cv::Mat base, const cv::Mat& blend);
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "BlendNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+#include "tinyfiledialogs.h"
+
+void BlendNodeUI::drawUI() {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
+    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom-right
+
+    // Gradient colors
+    ImVec4 color1 = ImVec4(85.0f / 255.0f, 0.0f / 255.0f, 40.0f / 255.0f, 1.0f);  
+    ImVec4 color2 = ImVec4(0.0f / 255.0f, 0.0f / 255.0f, 0.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),  // top left to top right
+        ImColor(color2), ImColor(color2)); // bottom left to bottom right
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0);
+    // Input selection for node input
+    ImGui::Text("Input Image:");
+    if (ImGui::BeginCombo("Input##Blend", 
+        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
+        
+        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
+            setInput(0, nullptr);
+            markDirty();
+        }
+        
+        for (Node* node : Node::availableNodes) {
+            if (node != this) {
+                bool is_selected = (inputs[0] == node);
+                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
+                    setInput(0, node);
+                    markDirty();
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    // Second image loader
+    if (ImGui::Button("Load Second Image")) {
+        const char* filters[] = { "*.jpg", "*.png", "*.bmp" };
+        const char* selected = tinyfd_openFileDialog(
+            "Open Second Image",
+            "",
+            3,
+            filters,
+            "Image files",
+            0
+        );
+
+        if (selected && loadSecondImage(selected)) {
+            secondImageVersion++;
+        }
+    }
+
+    // Preview second image if loaded
+    secondImagePreview.draw("Second Image:", "", secondImageVersion, [&] { return params.secondImage; });
+
+    // Blend mode selection
+    const char* modes[] = { "Normal", "Multiply", "Screen", "Overlay", "Difference" };
+    if (ImGui::Combo("Blend Mode", &params.blendMode, modes, IM_ARRAYSIZE(modes))) {
+        markDirty();
+    }
+
+    // Opacity slider
+    if (ImGui::SliderFloat("Opacity", &params.opacity, 0.0f, 1.0f)) {
+        markDirty();
+    }
+
+    // Display result
+    resultPreview.drawResult("Result:", *this);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+#include "BlendNode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for BlendNode: ImGui controls, second image picker and previews
+class BlendNodeUI : public BlendNode {
+public:
+    using BlendNode::BlendNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage resultPreview{this, 0, ImVec2(300, 300)};
+    PreviewImage secondImagePreview{this, 1, ImVec2(150, 150), false};
+    uint64_t secondImageVersion = 0;  // bumped by every image loaded
+};
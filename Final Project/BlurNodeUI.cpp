@@ -0,0 +1,102 @@
+#include "BlurNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+
+void BlurNodeUI::refreshTextures() {
+    if (textureGeneration == generation) return;
+    textureGeneration = generation;
+
+    if (!output.read().empty()) {
+        // Update kernel preview
+        updateKernelPreview();
+    }
+}
+
+void BlurNodeUI::drawUI() {
+    // Raised again below while any slider is being dragged, see GraphExecutor::setProxyScale
+    interacting = false;
+
+    refreshTextures();
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
+    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom right
+
+    // Gradient colors
+    ImVec4 color1 = ImVec4(106.0f / 255.0f, 90.0f / 255.0f, 205.0f / 255.0f, 1.0f);
+    ImVec4 color2 = ImVec4(48.0f / 255.0f, 25.0f / 255.0f, 52.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),  // top left to top right
+        ImColor(color2), ImColor(color2)); // bottom left to bottom right
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0); 
+    // Input selection
+    ImGui::Text("Input Selection:");
+    if (ImGui::BeginCombo("Input Image##Blur", 
+        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
+        
+        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
+            setInput(0, nullptr);
+            markDirty();
+        }
+        
+        for (Node* node : Node::availableNodes) {
+            if (node != this) {
+                bool is_selected = (inputs[0] == node);
+                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
+                    setInput(0, node);
+                    markDirty();
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    // Blur controls
+    ImGui::Text("Blur Settings");
+    
+    if (ImGui::SliderInt("Radius", &params.radius, 1, 20)) {
+        markDirty();
+    }
+    interacting |= ImGui::IsItemActive();
+
+    if (ImGui::Checkbox("Directional Blur", &params.directionalBlur)) {
+        markDirty();
+    }
+
+    if (params.directionalBlur) {
+        if (ImGui::SliderFloat("Angle", &params.angle, 0.0f, 360.0f)) {
+            markDirty();
+        }
+        interacting |= ImGui::IsItemActive();
+    }
+
+    // Display kernel preview
+    if (kernelTexture) {
+        ImGui::Text("Kernel Preview:");
+        ImGui::Image((ImTextureID)(intptr_t)kernelTexture, ImVec2(100, 100));
+    }
+
+    // Display result preview, or the blur so far while it renders
+    resultPreview.drawResult("Result Preview:", *this);
+}
+
+void BlurNodeUI::updateKernelPreview() {
+    cv::Mat kernel;
+    if (params.directionalBlur) {
+        kernel = createDirectionalKernel(2 * params.radius + 1, params.angle);
+    } else {
+        kernel = createGaussianKernel(2 * params.radius + 1, params.radius/3.0);
+    }
+    
+    // Normalize for display
+    cv::Mat kernelDisplay;
+    cv::normalize(kernel, kernelDisplay, 0, 255, cv::NORM_MINMAX);
+    kernelDisplay.convertTo(kernelDisplay, CV_8U);
+    
+    // Update texture
+    kernelTexture = TextureCache::shared().update(this, 1, kernelDisplay);
+}
\ No newline at end of file
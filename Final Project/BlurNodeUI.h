@@ -0,0 +1,22 @@
+#pragma once
+#include "blurnode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for BlurNode: ImGui controls and preview textures
+class BlurNodeUI : public BlurNode {
+public:
+    using BlurNode::BlurNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage resultPreview{this, 0, ImVec2(300, 300)};
+    GLuint kernelTexture = 0;  // For displaying the kernel
+    uint64_t textureGeneration = 0;
+
+    // Methods
+    void refreshTextures();
+    void updateKernelPreview();
+};
@@ -1,20 +1,44 @@
 #pragma once
 #include "Node.h"
-#include <GL/glew.h>
+#include "ResultSlot.h"
 
 class BrightnessContrastNode : public Node {
 public:
-    float brightness = 0.0f;
-    float contrast = 1.0f;
-    cv::Mat output;
-    GLuint texture = 0;
+    struct Params {
+        float brightness = 0.0f;
+        float contrast = 1.0f;
+
+        auto tie() const { return std::tie(brightness, contrast); }
+        bool operator==(const Params& other) const { return tie() == other.tie(); }
+        size_t hash() const { return hashTuple(tie()); }
+        void visit(ParamVisitor& v) {
+            v.field("brightness", brightness);
+            v.field("contrast", contrast);
+        }
+    };
+
+    Params params;  // edited by the UI
+    ResultSlot<Frame> output;
 
     BrightnessContrastNode(int id);
 
     void process() override;
-    cv::Mat getOutput() const override;
-    void drawUI() override;
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return output.take(); }
+    size_t paramsHash() const override { return jobParams.hash(); }
+    const char* typeName() const override { return "BrightnessContrastNode"; }
+    void visitParams(ParamVisitor& v) override { params.visit(v); }
+
+    int footprint() const override { return 1; }
+    cv::Mat processTile(const ImageView& input, cv::Rect inputArea, cv::Rect area) override {
+        cv::Mat result;
+        input(area - inputArea.tl()).convertTo(result, -1, jobParams.contrast, jobParams.brightness);
+        return result;
+    }
+    void publishTiles(Frame result) override { output.publish(std::move(result)); }
 
 private:
-    GLuint matToTexture(const cv::Mat& mat);
+    Params jobParams;  // snapshot read by process()
+
+    void captureParams() override { jobParams = params; }
 };
\ No newline at end of file
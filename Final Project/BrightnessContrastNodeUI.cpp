@@ -0,0 +1,68 @@
+#include "BrightnessContrastNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+
+void BrightnessContrastNodeUI::drawUI() {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
+    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom right
+
+    // Gradient colors
+    ImVec4 color1 = ImVec4(70.0f / 255.0f, 70.0f / 255.0f, 70.0f / 255.0f, 1.0f); 
+    ImVec4 color2 = ImVec4(40.0f / 255.0f, 40.0f / 255.0f, 40.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),  // top left to top right
+        ImColor(color2), ImColor(color2)); // bottom left to bottom right
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0);
+    // Input selection dropdown
+    ImGui::Text("Input Selection:");
+    if (ImGui::BeginCombo("Input Image##BC", 
+        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
+        
+        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
+            setInput(0, nullptr);
+            markDirty();
+        }
+        
+        for (Node* node : Node::availableNodes) {
+            if (node != this) {
+                bool is_selected = (inputs[0] == node);
+                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
+                    setInput(0, node);
+                    markDirty();
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    // Brightness and contrast controls
+    ImGui::Text("Adjust Brightness & Contrast");
+
+    if (ImGui::SliderFloat("Brightness", &params.brightness, -100.0f, 100.0f)) {
+        markDirty();
+    }
+
+    if (ImGui::Button("Reset Brightness")) {
+        params.brightness = 0.0f;
+        markDirty();
+    }
+
+    ImGui::Spacing();
+
+    if (ImGui::SliderFloat("Contrast", &params.contrast, 0.0f, 3.0f)) {
+        markDirty();
+    }
+
+    if (ImGui::Button("Reset Contrast")) {
+        params.contrast = 1.0f;
+        markDirty();
+    }
+
+    ImGui::Spacing();
+    resultPreview.drawResult("Preview:", *this);
+}
\ No newline at end of file
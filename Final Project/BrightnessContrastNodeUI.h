@@ -0,0 +1,16 @@
+#pragma once
+#include "BrightnessContrastNode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for BrightnessContrastNode: ImGui controls and preview texture
+class BrightnessContrastNodeUI : public BrightnessContrastNode {
+public:
+    using BrightnessContrastNode::BrightnessContrastNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage resultPreview{this, 0, ImVec2(300, 300)};
+};
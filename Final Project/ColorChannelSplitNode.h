@@ -1,24 +1,42 @@
 #pragma once
 #include "Node.h"
-#include <GL/glew.h>
+#include "ResultSlot.h"
 #include <opencv2/opencv.hpp>
 
 class ColorChannelSplitNode : public Node {
 public:
-    cv::Mat redChannel, greenChannel, blueChannel, alphaChannel;
-    GLuint redTex = 0, greenTex = 0, blueTex = 0, alphaTex = 0;
-    bool grayscale = true;
-    GLuint textures[4] = {0};
-    int selectedChannel = 0;
+    struct Params {
+        bool grayscale = false;
+        int selectedChannel = 0;
+
+        auto tie() const { return std::tie(grayscale, selectedChannel); }
+        bool operator==(const Params& other) const { return tie() == other.tie(); }
+        size_t hash() const { return hashTuple(tie()); }
+        void visit(ParamVisitor& v) {
+            v.field("grayscale", grayscale);
+            v.field("selectedChannel", selectedChannel);
+        }
+    };
+
+    Params params;  // edited by the UI
+    ResultSlot<Frame> redChannel, greenChannel, blueChannel;
+    ResultSlot<Frame> output;  // the selected channel
 
     ColorChannelSplitNode(int id);
 
     void process() override;
-    cv::Mat getOutput() const override;
-    void drawUI() override;
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return output.take(); }
+    std::vector<Frame> results() const override;
+    size_t paramsHash() const override { return jobParams.hash(); }
+    const char* typeName() const override { return "ColorChannelSplitNode"; }
+    void visitParams(ParamVisitor& v) override { params.visit(v); }
     
 
 
 private:
-    GLuint matToTexture(const cv::Mat& mat);
+    Params jobParams;  // snapshot read by process()
+
+    void captureParams() override { jobParams = params; }
+    void releaseResults() override;
 };
\ No newline at end of file
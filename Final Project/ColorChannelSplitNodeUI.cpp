@@ -0,0 +1,69 @@
+#include "ColorChannelSplitNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+
+void ColorChannelSplitNodeUI::drawUI() {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
+    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom right
+
+    // Gradient colors
+    ImVec4 color1 = ImVec4(0.0f / 255.0f, 128.0f / 255.0f, 128.0f / 255.0f, 1.0f);
+    ImVec4 color2 = ImVec4(0.0f / 255.0f, 0.0f / 255.0f, 0.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),  // top left to top right
+        ImColor(color2), ImColor(color2)); // bottom left to bottom right
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0); 
+    // Add input selection dropdown
+    ImGui::Text("Input Selection:");
+    if (ImGui::BeginCombo("Input Image##CS", 
+        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
+        
+        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
+            setInput(0, nullptr);
+            markDirty();
+        }
+        
+        for (Node* node : Node::availableNodes) {
+            if (node != this) {
+                bool is_selected = (inputs[0] == node);
+                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
+                    setInput(0, node);
+                    markDirty();
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    ImGui::Text("Color Channel Splitter");
+
+    if (ImGui::Checkbox("Grayscale Output", &params.grayscale)) {
+        markDirty();
+    }
+
+    //channel selection
+    const char* channels[] = { "Blue Channel", "Green Channel", "Red Channel" };
+    if (ImGui::Combo("Output Channel", &params.selectedChannel, channels, IM_ARRAYSIZE(channels))) {
+        markDirty();
+    }
+
+    const char* labels[3] = { "Blue", "Green", "Red" };
+    const ResultSlot<Frame>* slots[3] = { &blueChannel, &greenChannel, &redChannel };
+    for (int i = 0; i < 3; ++i) {
+        if (i == params.selectedChannel){
+            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 0.0f, 1.0f));
+        }
+        std::string label = std::string(labels[i]) + " Channel:";
+        channelPreviews[i].draw(label.c_str(), getName() + " " + labels[i] + " (full resolution)", generation,
+                                [&] { return slots[i]->read().view(); });
+
+        if (i == params.selectedChannel) {
+            ImGui::PopStyleColor();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+#include "ColorChannelSplitNode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for ColorChannelSplitNode: ImGui controls and one preview
+// texture per channel
+class ColorChannelSplitNodeUI : public ColorChannelSplitNode {
+public:
+    using ColorChannelSplitNode::ColorChannelSplitNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage channelPreviews[3] = {
+        {this, 0, ImVec2(150, 150)}, {this, 1, ImVec2(150, 150)}, {this, 2, ImVec2(150, 150)}};
+};
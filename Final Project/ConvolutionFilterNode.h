@@ -1,25 +1,44 @@
 #pragma once
 #include "Node.h"
-#include <GL/glew.h>
+#include "ResultSlot.h"
 
 class ConvolutionFilterNode : public Node {
 public:
+    // Kernel parameters
+    static const int MAX_KERNEL_SIZE = 5;
+    struct Params {
+        int kernelSize = 3;  // 3x3 or 5x5
+        std::vector<float> kernel;
+        float kernelDivisor = 1.0f;
+        float kernelOffset = 0.0f;
+
+        auto tie() const { return std::tie(kernelSize, kernel, kernelDivisor, kernelOffset); }
+        bool operator==(const Params& other) const { return tie() == other.tie(); }
+        size_t hash() const { return hashTuple(tie()); }
+        void visit(ParamVisitor& v) {
+            v.field("kernelSize", kernelSize);
+            v.field("kernel", kernel);
+            v.field("kernelDivisor", kernelDivisor);
+            v.field("kernelOffset", kernelOffset);
+        }
+    };
+
     ConvolutionFilterNode(int id);
     void process() override;
-    cv::Mat getOutput() const override;
-    void drawUI() override;
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return output.take(); }
+    size_t paramsHash() const override { return jobParams.hash(); }
+    const char* typeName() const override { return "ConvolutionFilterNode"; }
+    void visitParams(ParamVisitor& v) override { params.visit(v); }
+    void paramsLoaded() override;
 
-private:
-    cv::Mat output;
-    GLuint texture = 0;
-    GLuint previewTexture = 0;  // For kernel effect preview
+    int footprint() const override { return jobParams.kernelSize; }
+    cv::Mat processTile(const ImageView& input, cv::Rect inputArea, cv::Rect area) override {
+        return applyKernel(input(area - inputArea.tl()), jobParams);
+    }
+    void publishTiles(Frame result) override { output.publish(std::move(result)); }
 
-    // Kernel parameters
-    static const int MAX_KERNEL_SIZE = 5;
-    int kernelSize = 3;  // 3x3 or 5x5
-    std::vector<float> kernel;
-    float kernelDivisor = 1.0f;
-    float kernelOffset = 0.0f;
+    Params params;  // edited by the UI
 
     // Preset filters
     enum class Preset {
@@ -31,12 +50,17 @@ private:
         GaussianBlur,
         EdgeDetect
     };
-    Preset currentPreset = Preset::Custom;
-
-    // Methods
-    GLuint matToTexture(const cv::Mat& mat);
     void applyPreset(Preset preset);
-    cv::Mat applyKernel(const cv::Mat& input);
-    void updatePreview();
     void resetKernel();
+
+protected:
+    ResultSlot<Frame> output;
+
+    cv::Mat applyKernel(cv::InputArray input, const Params& kernelParams);
+
+private:
+    Params jobParams;  // snapshot read by process()
+
+    // Methods
+    void captureParams() override { jobParams = params; }
 };
\ No newline at end of file
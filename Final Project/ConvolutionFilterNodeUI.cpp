@@ -0,0 +1,136 @@
+#include "ConvolutionFilterNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+
+void ConvolutionFilterNodeUI::updatePreview() {
+    // Create a simple gradient image for preview
+    cv::Mat previewInput(100, 100, CV_8UC1);
+    for (int i = 0; i < previewInput.rows; i++) {
+        for (int j = 0; j < previewInput.cols; j++) {
+            previewInput.at<uchar>(i, j) = (i + j) * 255 / (previewInput.rows + previewInput.cols);
+        }
+    }
+
+    // Apply kernel to preview
+    cv::Mat previewResult = applyKernel(previewInput, params);
+
+    // Update preview texture
+    previewTexture = TextureCache::shared().update(this, 1, previewResult);
+}
+
+void ConvolutionFilterNodeUI::refreshTextures() {
+    if (textureGeneration == generation) return;
+    textureGeneration = generation;
+
+    if (!output.read().empty()) {
+        // Update preview
+        updatePreview();
+    }
+}
+
+void ConvolutionFilterNodeUI::drawUI() {
+    // Raised again below while any slider is being dragged, see GraphExecutor::setProxyScale
+    interacting = false;
+
+    refreshTextures();
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
+    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom right
+
+    // Gradient colors
+    ImVec4 color1 = ImVec4(85.0f / 255.0f, 107.0f / 255.0f, 47.0f / 255.0f, 1.0f);
+    ImVec4 color2 = ImVec4(0.0f / 255.0f, 0.0f / 255.0f, 0.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),  // top left to top right
+        ImColor(color2), ImColor(color2)); // bottom left to bottom right
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0); 
+    // Input selection
+    ImGui::Text("Input Image:");
+    if (ImGui::BeginCombo("Input##Conv", 
+        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
+        
+        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
+            setInput(0, nullptr);
+            markDirty();
+        }
+        
+        for (Node* node : Node::availableNodes) {
+            if (node != this) {
+                bool is_selected = (inputs[0] == node);
+                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
+                    setInput(0, node);
+                    markDirty();
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    // Preset selection
+    const char* presets[] = {"Custom", "Sharpen", "Emboss", "Edge Enhance", 
+                            "Box Blur", "Gaussian Blur", "Edge Detect"};
+    int presetIndex = static_cast<int>(currentPreset);
+    if (ImGui::Combo("Preset", &presetIndex, presets, IM_ARRAYSIZE(presets))) {
+        currentPreset = static_cast<Preset>(presetIndex);
+        applyPreset(currentPreset);
+    }
+
+    // Kernel size selection (only for custom)
+    if (currentPreset == Preset::Custom) {
+        if (ImGui::RadioButton("3x3", params.kernelSize == 3)) {
+            params.kernelSize = 3;
+            resetKernel();
+            markDirty();
+        }
+        ImGui::SameLine();
+        if (ImGui::RadioButton("5x5", params.kernelSize == 5)) {
+            params.kernelSize = 5;
+            resetKernel();
+            markDirty();
+        }
+    }
+
+    // Kernel matrix editor
+    ImGui::Text("Kernel Matrix:");
+    bool kernelChanged = false;
+    for (int i = 0; i < params.kernelSize; i++) {
+        for (int j = 0; j < params.kernelSize; j++) {
+            if (j > 0) ImGui::SameLine();
+            float& value = params.kernel[i * params.kernelSize + j];
+            ImGui::PushID(i * params.kernelSize + j);  // unique ID without building a label
+            if (ImGui::DragFloat("##K", &value, 0.1f, -10.0f, 10.0f, "%.3f")) {
+                kernelChanged = true;
+            }
+            interacting |= ImGui::IsItemActive();
+            ImGui::PopID();
+        }
+    }
+
+    // Kernel parameters
+    if (ImGui::DragFloat("Divisor", &params.kernelDivisor, 0.1f, 0.1f, 1000.0f, "%.3f")) {
+        kernelChanged = true;
+    }
+    interacting |= ImGui::IsItemActive();
+    if (ImGui::DragFloat("Offset", &params.kernelOffset, 1.0f, -255.0f, 255.0f)) {
+        kernelChanged = true;
+    }
+    interacting |= ImGui::IsItemActive();
+
+    if (kernelChanged) {
+        markDirty();
+    }
+
+    // Preview
+    if (previewTexture) {
+        ImGui::Text("Kernel Effect Preview:");
+        ImGui::Image((ImTextureID)(intptr_t)previewTexture, ImVec2(100, 100));
+    }
+
+    // Result
+    resultPreview.drawResult("Result:", *this);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+#include "ConvolutionFilterNode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for ConvolutionFilterNode: preset picker, kernel matrix
+// editor and previews
+class ConvolutionFilterNodeUI : public ConvolutionFilterNode {
+public:
+    using ConvolutionFilterNode::ConvolutionFilterNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage resultPreview{this, 0, ImVec2(300, 300)};
+    GLuint previewTexture = 0;  // For kernel effect preview
+    uint64_t textureGeneration = 0;
+    Preset currentPreset = Preset::Custom;
+
+    // Methods
+    void refreshTextures();
+    void updatePreview();
+};
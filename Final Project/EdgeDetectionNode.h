@@ -1,40 +1,73 @@
 #pragma once
 #include "Node.h"
-#include <GL/glew.h>
+#include "ResultSlot.h"
 
 class EdgeDetectionNode : public Node {
 public:
+    // Edge detection parameters
+    struct Params {
+        bool useCanny = true;
+        bool overlayEdges = false;
+
+        // Canny parameters
+        int cannyThreshold1 = 100;
+        int cannyThreshold2 = 200;
+        int cannyAperture = 3;
+
+        // Sobel parameters
+        int sobelKSize = 3;
+        float sobelScale = 1.0f;
+        float sobelDelta = 0.0f;
+        bool sobelX = true;
+        bool sobelY = true;
+
+        auto tie() const {
+            return std::tie(useCanny, overlayEdges, cannyThreshold1, cannyThreshold2, cannyAperture,
+                            sobelKSize, sobelScale, sobelDelta, sobelX, sobelY);
+        }
+        bool operator==(const Params& other) const { return tie() == other.tie(); }
+        size_t hash() const { return hashTuple(tie()); }
+        void visit(ParamVisitor& v) {
+            v.field("useCanny", useCanny);
+            v.field("overlayEdges", overlayEdges);
+            v.field("cannyThreshold1", cannyThreshold1);
+            v.field("cannyThreshold2", cannyThreshold2);
+            v.field("cannyAperture", cannyAperture);
+            v.field("sobelKSize", sobelKSize);
+            v.field("sobelScale", sobelScale);
+            v.field("sobelDelta", sobelDelta);
+            v.field("sobelX", sobelX);
+            v.field("sobelY", sobelY);
+        }
+    };
+
     EdgeDetectionNode(int id);
     void process() override;
-    cv::Mat getOutput() const override;
-    void drawUI() override;
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return output.take(); }
+    size_t paramsHash() const override { return jobParams.hash(); }
+    const char* typeName() const override { return "EdgeDetectionNode"; }
+    void visitParams(ParamVisitor& v) override { params.visit(v); }
+
+    // Sobel reads a kernel-sized window (3x1 for size 1); Canny's hysteresis
+    // follows edges across the whole image
+    int footprint() const override { return jobParams.useCanny ? 0 : std::max(3, jobParams.sobelKSize); }
+    cv::Mat processTile(const ImageView& input, cv::Rect inputArea, cv::Rect area) override;
+    void publishTiles(Frame result) override { output.publish(std::move(result)); }
 
+    Params params;  // edited by the UI
 
 
+
+protected:
+    ResultSlot<Frame> output;
+
 private:
-    cv::Mat output;
-    cv::Mat overlayOutput;  // For edge overlay on original
-    GLuint texture = 0;
-    
-    // Edge detection parameters
-    bool useCanny = true;
-    bool overlayEdges = false;
-    
-    // Canny parameters
-    int cannyThreshold1 = 100;
-    int cannyThreshold2 = 200;
-    int cannyAperture = 3;
-    
-    // Sobel parameters
-    int sobelKSize = 3;
-    float sobelScale = 1.0f;
-    float sobelDelta = 0.0f;
-    bool sobelX = true;
-    bool sobelY = true;
+    Params jobParams;  // snapshot read by process()
     
     // Methods
-    GLuint matToTexture(const cv::Mat& mat);
-    cv::Mat applySobel(const cv::Mat& input);
-    cv::Mat applyCanny(const cv::Mat& input);
-    cv::Mat createOverlay(const cv::Mat& original, const cv::Mat& edges);
+    void captureParams() override { jobParams = params; }
+    cv::Mat applySobel(const ImageView& input);
+    cv::Mat applyCanny(const ImageView& input);
+    cv::Mat createOverlay(cv::Mat overlay, const cv::Mat& edges);  // draws into overlay
 };
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "EdgeDetectionNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+
+void EdgeDetectionNodeUI::drawUI() {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
+    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom right
+
+    // Gradient colors
+    ImVec4 color1 = ImVec4(102.0f / 255.0f, 51.0f / 255.0f, 102.0f / 255.0f, 1.0f);
+    ImVec4 color2 = ImVec4(0.0f / 255.0f, 0.0f / 255.0f, 0.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),  // top left to top right
+        ImColor(color2), ImColor(color2)); // bottom left to bottom right
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0); 
+    // Input selection
+    ImGui::Text("Input Selection:");
+    if (ImGui::BeginCombo("Input Image##Edge", 
+        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
+        
+        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
+            setInput(0, nullptr);
+            markDirty();
+        }
+        
+        for (Node* node : Node::availableNodes) {
+            if (node != this) {
+                bool is_selected = (inputs[0] == node);
+                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
+                    setInput(0, node);
+                    markDirty();
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    // Edge detection settings
+    ImGui::Text("Edge Detection Settings");
+
+    if (ImGui::Checkbox("Use Canny (else Sobel)", &params.useCanny)) {
+        markDirty();
+    }
+
+    if (ImGui::Checkbox("Overlay Edges", &params.overlayEdges)) {
+        markDirty();
+    }
+
+    if (params.useCanny) {
+        // Canny parameters
+        ImGui::Text("Canny Parameters:");
+        if (ImGui::SliderInt("Threshold 1", &params.cannyThreshold1, 0, 255)) {
+            markDirty();
+        }
+        if (ImGui::SliderInt("Threshold 2", &params.cannyThreshold2, 0, 255)) {
+            markDirty();
+        }
+        if (ImGui::SliderInt("Aperture", &params.cannyAperture, 3, 7, "%d", ImGuiSliderFlags_AlwaysClamp)) {
+            params.cannyAperture = (params.cannyAperture / 2) * 2 + 1; // Ensure odd number
+            markDirty();
+        }
+    } else {
+        // Sobel parameters
+        ImGui::Text("Sobel Parameters:");
+        if (ImGui::Checkbox("Detect X", &params.sobelX)) {
+            markDirty();
+        }
+        ImGui::SameLine();
+        if (ImGui::Checkbox("Detect Y", &params.sobelY)) {
+            markDirty();
+        }
+        if (ImGui::SliderInt("Kernel Size", &params.sobelKSize, 1, 7, "%d", ImGuiSliderFlags_AlwaysClamp)) {
+            params.sobelKSize = (params.sobelKSize / 2) * 2 + 1; // Ensure odd number
+            markDirty();
+        }
+        if (ImGui::SliderFloat("Scale", &params.sobelScale, 0.1f, 5.0f)) {
+            markDirty();
+        }
+        if (ImGui::SliderFloat("Delta", &params.sobelDelta, -5.0f, 5.0f)) {
+            markDirty();
+        }
+    }
+
+    // Display result
+    resultPreview.drawResult("Result:", *this);
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include "EdgeDetectionNode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for EdgeDetectionNode: ImGui controls and preview texture
+class EdgeDetectionNodeUI : public EdgeDetectionNode {
+public:
+    using EdgeDetectionNode::EdgeDetectionNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage resultPreview{this, 0, ImVec2(300, 300)};
+};
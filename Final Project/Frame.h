@@ -0,0 +1,111 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <utility>
+
+// Read-only access to pixels a frame shares. It keeps them alive like a
+// cv::Mat does, but hands them out only as OpenCV input arrays and const
+// elements, so code that reads a frame cannot write to it by accident.
+class ImageView {
+public:
+    ImageView() = default;
+    explicit ImageView(cv::Mat image) : pixels(std::move(image)) {}
+
+    // Any OpenCV function that only reads its argument takes a view directly
+    operator cv::_InputArray() const { return cv::_InputArray(pixels); }
+
+    bool empty() const { return pixels.empty(); }
+    cv::Size size() const { return pixels.size(); }
+    int rows() const { return pixels.rows; }
+    int cols() const { return pixels.cols; }
+    int type() const { return pixels.type(); }
+    int depth() const { return pixels.depth(); }
+    int channels() const { return pixels.channels(); }
+
+    template <typename T>
+    const T& at(int row, int col) const { return pixels.at<T>(row, col); }
+    template <typename T>
+    const T* ptr(int row = 0) const { return pixels.ptr<T>(row); }
+
+    // The pixels of area, without a copy
+    ImageView operator()(const cv::Rect& area) const { return ImageView(pixels(area)); }
+
+    // Writable copies
+    cv::Mat clone() const { return pixels.clone(); }
+    void copyTo(cv::OutputArray target) const { pixels.copyTo(target); }
+    void convertTo(cv::OutputArray target, int type, double alpha = 1, double beta = 0) const {
+        pixels.convertTo(target, type, alpha, beta);
+    }
+
+private:
+    cv::Mat pixels;
+};
+
+// An immutable, reference-counted image: what nodes publish and read from each
+// other. Copies share the pixels and only give read access to them, so one
+// result fans out to any number of consumers without a copy and none of them
+// can change what the others see.
+//
+// A kernel that wants to write over its input takes the pixels out of its own
+// frame. That is copy-on-write: the pixels are moved out when no other frame,
+// view or Mat refers to them (an input handed over by Node::takeInput) and
+// copied otherwise.
+//
+// A frame may hold only a region of an image (see Node::jobRegion), or a proxy
+// computed at a reduced scale (see Node::jobScale). It carries where the region
+// sits and the scale, so whoever reads the frame sees pixels, placement and
+// scale from the same result.
+class Frame {
+public:
+    Frame() = default;
+    // the caller hands image over; scale n means 1/n of full resolution
+    explicit Frame(cv::Mat image, int scale = 1) : pixels(std::move(image)), proxyScale(scale) {}
+    // image is area of an image of imageSize
+    Frame(cv::Mat image, cv::Rect area, cv::Size imageSize, int scale = 1)
+        : pixels(std::move(image)), region(area), fullSize(imageSize), proxyScale(scale) {}
+
+    ImageView view() const { return ImageView(pixels); }
+    bool empty() const { return pixels.empty(); }
+    cv::Size size() const { return pixels.size(); }
+    int type() const { return pixels.type(); }
+    int channels() const { return pixels.channels(); }
+
+    // Where the pixels sit in their image, and its size: all of it unless the
+    // frame holds a region
+    bool isRegion() const { return !region.empty(); }
+    cv::Rect area() const { return isRegion() ? region : cv::Rect(0, 0, pixels.cols, pixels.rows); }
+    cv::Size imageSize() const { return isRegion() ? fullSize : size(); }
+
+    // 1 for full resolution, n for a proxy computed at 1/n of it
+    int scale() const { return proxyScale; }
+
+    // The buffer holding the pixels, to tell frames sharing one apart
+    const cv::UMatData* buffer() const { return pixels.u; }
+
+    // True if nothing but this frame refers to the pixels. Other threads may
+    // drop their references meanwhile, so the count is read atomically.
+    bool unique() const { return pixels.u && CV_XADD(&pixels.u->refcount, 0) == 1; }
+
+    // The pixels, writable, if nothing else refers to them, and the frame is
+    // left empty; an empty Mat and the frame unchanged otherwise. For kernels
+    // that can write their result over their input.
+    cv::Mat takeBuffer() {
+        if (!unique()) return cv::Mat();
+        cv::Mat buffer = std::move(pixels);
+        pixels.release();
+        return buffer;
+    }
+
+    // The pixels, writable: this frame's own if nothing else refers to them,
+    // otherwise a copy. The frame is left empty either way.
+    cv::Mat takeWritable() {
+        cv::Mat buffer = unique() ? std::move(pixels) : pixels.clone();
+        pixels.release();
+        return buffer;
+    }
+
+private:
+    cv::Mat pixels;
+    cv::Rect region;
+    cv::Size fullSize;
+    int proxyScale = 1;
+};
\ No newline at end of file
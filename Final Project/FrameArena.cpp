@@ -0,0 +1,35 @@
+#include "FrameArena.h"
+
+namespace {
+// The first 64 KB of every scope come from a buffer reserved once per thread;
+// anything beyond is taken from the heap in growing chunks until the scope ends
+struct ThreadArena {
+    static const size_t INITIAL_SIZE = 64 * 1024;
+
+    alignas(std::max_align_t) std::byte buffer[INITIAL_SIZE];
+    std::pmr::monotonic_buffer_resource bump{buffer, INITIAL_SIZE, std::pmr::new_delete_resource()};
+    int depth = 0;  // open scopes
+};
+
+ThreadArena& threadArena() {
+    thread_local ThreadArena arena;
+    return arena;
+}
+}
+
+FrameArena::Scope::Scope() {
+    threadArena().depth++;
+}
+
+FrameArena::Scope::~Scope() {
+    ThreadArena& arena = threadArena();
+    if (--arena.depth == 0) {
+        arena.bump.release();
+    }
+}
+
+std::pmr::memory_resource* FrameArena::resource() {
+    ThreadArena& arena = threadArena();
+    if (arena.depth == 0) return std::pmr::new_delete_resource();
+    return &arena.bump;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+// Bump allocator for the small temporaries of one evaluation: histograms and
+// channel headers. Memory comes from a per-thread buffer
+// through std::pmr, so containers use it as
+//
+//   std::pmr::vector<int> histogram(256, 0, FrameArena::resource());
+//
+// and it is all given back at once when the outermost Scope on the thread
+// closes, instead of one free() per container. Node::evaluate() opens a scope
+// around process(). Outside any scope, resource() is the ordinary heap.
+class FrameArena {
+public:
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    static std::pmr::memory_resource* resource();
+};
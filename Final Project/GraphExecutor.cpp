@@ -0,0 +1,362 @@
+#include "GraphExecutor.h"
+#include "ThreadPool.h"
+#include "MemoryBudget.h"
+#include "TileGrid.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <iostream>
+#include <unordered_map>
+
+std::vector<Node*> GraphExecutor::topologicalOrder(const std::vector<Node*>& nodes,
+                                                   std::vector<Node*>* cyclic) {
+    std::unordered_map<Node*, int> pendingInputs;
+    std::unordered_map<Node*, std::vector<Node*>> consumers;
+
+    for (Node* node : nodes) {
+        pendingInputs[node] = 0;
+    }
+
+    // Only count edges between nodes that take part in this evaluation
+    for (Node* node : nodes) {
+        for (Node* input : node->inputs) {
+            if (input && pendingInputs.count(input)) {
+                pendingInputs[node]++;
+                consumers[input].push_back(node);
+            }
+        }
+    }
+
+    std::vector<Node*> order;
+    order.reserve(nodes.size());
+    for (Node* node : nodes) {
+        if (pendingInputs[node] == 0) {
+            order.push_back(node);
+        }
+    }
+
+    // order doubles as the work queue; preserving registration order among
+    // independent nodes keeps evaluation deterministic
+    for (size_t i = 0; i < order.size(); i++) {
+        for (Node* consumer : consumers[order[i]]) {
+            if (--pendingInputs[consumer] == 0) {
+                order.push_back(consumer);
+            }
+        }
+    }
+
+    if (cyclic) {
+        cyclic->clear();
+        for (Node* node : nodes) {
+            if (pendingInputs[node] > 0) {
+                cyclic->push_back(node);
+            }
+        }
+    }
+    return order;
+}
+
+std::unordered_set<Node*> GraphExecutor::upstreamOf(const std::vector<Node*>& requested) {
+    std::unordered_set<Node*> needed;
+    std::vector<Node*> stack(requested.begin(), requested.end());
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if (!node || !needed.insert(node).second) continue;
+        stack.insert(stack.end(), node->inputs.begin(), node->inputs.end());
+    }
+    return needed;
+}
+
+GraphExecutor::Plan GraphExecutor::plan(const std::vector<Node*>& nodes, const std::vector<Node*>& requested) {
+    std::vector<Node*> cyclic;
+    std::vector<Node*> order = topologicalOrder(nodes, &cyclic);
+
+    // Pull: drop nodes nothing requested depends on. They keep their dirty flag
+    // and are picked up by the first plan that needs them.
+    std::unordered_set<Node*> needed = upstreamOf(requested);
+    order.erase(std::remove_if(order.begin(), order.end(), [&](Node* node) { return !needed.count(node); }),
+                order.end());
+
+    // Only report when the set of unreachable nodes changes, not every frame
+    if (cyclic != cycleNodes) {
+        cycleNodes = cyclic;
+        if (!cycleNodes.empty()) {
+            std::cerr << "Cycle detected in node graph, skipping:";
+            for (Node* node : cycleNodes) {
+                std::cerr << " " << node->getName();
+            }
+            std::cerr << std::endl;
+        }
+    }
+
+    if (memoryBudget) {
+        memoryBudget->enforce(nodes, requested);
+    }
+
+    // A node runs if it needs an update now or if any of its inputs is going to
+    // run before it. Generation counters make "did an input change since I last
+    // ran" an O(1) check per edge, regardless of when upstream dirty flags were
+    // cleared.
+    std::unordered_set<Node*> wanted(requested.begin(), requested.end());
+    std::unordered_map<Node*, size_t> position;
+    std::vector<char> runs(order.size(), 0);
+    for (size_t i = 0; i < order.size(); i++) {
+        Node* node = order[i];
+        position[node] = i;
+        runs[i] = node->needsUpdate() || (node->outputReleased && wanted.count(node)) ||
+                  node->resultScale != proxyScale;
+        for (Node* input : node->inputs) {
+            auto it = input ? position.find(input) : position.end();
+            if (it != position.end() && runs[it->second]) runs[i] = true;
+        }
+    }
+
+    // A result handed over to its consumer is gone; the node that made it runs
+    // again before anything reads it
+    for (size_t i = order.size(); i-- > 0;) {
+        if (!runs[i]) continue;
+        for (Node* input : order[i]->inputs) {
+            auto it = input ? position.find(input) : position.end();
+            if (it != position.end() && input->outputReleased) runs[it->second] = true;
+        }
+    }
+
+    // Jobs take their parameter snapshot before the regions of interest are
+    // worked out, which depend on the footprints of the parameters they run with
+    for (size_t i = 0; i < order.size(); i++) {
+        if (runs[i]) prepareJob(order[i]);
+    }
+    assignRegions(order, wanted, position, runs);
+
+    Plan plan;
+    std::unordered_map<Node*, size_t> index;
+    std::vector<int> depth;
+    for (size_t i = 0; i < order.size(); i++) {
+        Node* node = order[i];
+        node->donatesOutput = false;
+        node->tiledByConsumer = false;
+        node->tileChain.clear();
+        if (!runs[i]) continue;
+
+        int level = 0;
+        for (Node* input : node->inputs) {
+            auto it = input ? index.find(input) : index.end();
+            if (it != index.end()) {
+                level = std::max(level, depth[it->second] + 1);
+            }
+        }
+        index[node] = plan.scheduled.size();
+        plan.scheduled.push_back(node);
+        depth.push_back(level);
+    }
+    if (plan.empty()) return plan;
+
+    // The widest level is how many nodes can be in flight at the same time
+    std::vector<int> levelWidth(*std::max_element(depth.begin(), depth.end()) + 1, 0);
+    for (int level : depth) levelWidth[level]++;
+    plan.width = *std::max_element(levelWidth.begin(), levelWidth.end());
+
+    size_t count = plan.scheduled.size();
+    plan.consumers.resize(count);
+    plan.inputCount.resize(count, 0);
+    for (size_t i = 0; i < count; i++) {
+        for (Node* input : plan.scheduled[i]->inputs) {
+            auto it = input ? index.find(input) : index.end();
+            if (it != index.end()) {
+                plan.consumers[it->second].push_back(i);
+                plan.inputCount[i]++;
+            }
+        }
+    }
+
+    // A node whose single consumer runs right after it, and whose result is not
+    // wanted for itself, lets that consumer take the buffer over. Pointwise
+    // kernels then write in place, so a chain holds one image instead of one
+    // per node.
+    if (inPlace) {
+        for (size_t i = 0; i < count; i++) {
+            Node* node = plan.scheduled[i];
+            node->donatesOutput = plan.consumers[i].size() == 1 && node->outputs.size() == 1 && !wanted.count(node);
+        }
+    }
+
+    // A tileable node whose result, under the same conditions, only feeds a
+    // tileable consumer joins that consumer's chain. The chain then runs a
+    // tile at a time from the input of its first node to the result of its
+    // last, and the intermediate tiles stay in cache.
+    if (tiled) {
+        for (size_t i = 0; i < count; i++) {
+            Node* node = plan.scheduled[i];
+            if (node->footprint() == 0) continue;
+            auto it = node->inputs[0] ? index.find(node->inputs[0]) : index.end();
+            if (it == index.end()) continue;
+
+            Node* input = node->inputs[0];
+            if (input->footprint() == 0 || plan.consumers[it->second].size() != 1 || input->outputs.size() != 1 ||
+                wanted.count(input)) {
+                continue;
+            }
+            node->tileChain = std::move(input->tileChain);
+            node->tileChain.push_back(input);
+            input->tileChain.clear();
+            input->tiledByConsumer = true;
+            input->donatesOutput = false;
+        }
+    }
+    return plan;
+}
+
+void GraphExecutor::prepareJob(Node* node) {
+    node->jobScale = proxyScale;
+    node->progressive = progressive && proxyScale == 1;
+    node->prepare();
+}
+
+void GraphExecutor::assignRegions(const std::vector<Node*>& order, const std::unordered_set<Node*>& wanted,
+                                  const std::unordered_map<Node*, size_t>& position, std::vector<char>& runs) {
+    // From the requested nodes back to the sources: each node needs the union
+    // of what its consumers read, their regions grown by their footprints.
+    // Proxies, nodes wanted whole, nodes that cannot compute a part of their
+    // result (footprint 0) and everything they read from need all of it.
+    auto assign = [&] {
+        std::vector<cv::Rect> region(order.size());
+        std::vector<char> whole(order.size(), proxyScale != 1);
+        for (size_t i = 0; i < order.size(); i++) {
+            if (wanted.count(order[i])) {
+                region[i] = order[i]->viewRegion;
+                if (region[i].empty()) whole[i] = true;
+            }
+        }
+        for (size_t i = order.size(); i-- > 0;) {
+            Node* node = order[i];
+            int footprint = node->footprint();
+            if (footprint == 0 || region[i].empty()) whole[i] = true;
+            node->jobRegion = whole[i] ? cv::Rect() : region[i];
+
+            for (Node* input : node->inputs) {
+                auto it = input ? position.find(input) : position.end();
+                if (it == position.end()) continue;
+                size_t j = it->second;
+                if (whole[i]) {
+                    whole[j] = true;
+                } else {
+                    cv::Rect read = TileGrid::grow(region[i], footprint / 2);
+                    region[j] = region[j].empty() ? read : (region[j] | read);
+                }
+            }
+        }
+    };
+
+    // A result that does not cover the region now needed is made again, and
+    // so is everything that reads it. Those jobs may in turn need results
+    // that were released. Footprints come from the parameter snapshots, which
+    // a node added here only takes now, so the regions are worked out again
+    // after every round that adds one.
+    auto covers = [](const cv::Rect& result, const cv::Rect& needed) {
+        return result.empty() || (!needed.empty() && (result & needed) == needed);
+    };
+    bool added = true;
+    while (added) {
+        assign();
+        added = false;
+        for (size_t i = 0; i < order.size(); i++) {
+            Node* node = order[i];
+            if (runs[i]) continue;
+            bool stale = !covers(node->resultRegion, node->jobRegion);
+            for (Node* input : node->inputs) {
+                auto it = input ? position.find(input) : position.end();
+                if (it != position.end() && runs[it->second]) stale = true;
+            }
+            if (stale) {
+                runs[i] = true;
+                prepareJob(node);
+                added = true;
+            }
+        }
+        for (size_t i = order.size(); i-- > 0;) {
+            if (!runs[i]) continue;
+            for (Node* input : order[i]->inputs) {
+                auto it = input ? position.find(input) : position.end();
+                if (it != position.end() && !runs[it->second] && input->outputReleased) {
+                    runs[it->second] = true;
+                    prepareJob(input);
+                    added = true;
+                }
+            }
+        }
+    }
+}
+
+void GraphExecutor::run(const Plan& plan) {
+    if (plan.empty()) return;
+
+    if (pool) {
+        runParallel(plan);
+        return;
+    }
+    for (Node* node : plan.scheduled) {
+        node->evaluate();
+    }
+}
+
+void GraphExecutor::runParallel(const Plan& plan) {
+    balanceOpenCVThreads(plan.width);
+
+    size_t count = plan.scheduled.size();
+    std::unique_ptr<std::atomic<int>[]> waitingOn(new std::atomic<int>[count]);
+    for (size_t i = 0; i < count; i++) {
+        waitingOn[i].store(plan.inputCount[i]);
+    }
+
+    std::mutex doneMutex;
+    std::condition_variable doneSignal;
+    size_t remaining = count;
+    std::exception_ptr failure;
+
+    std::function<void(size_t)> run = [&](size_t i) {
+        try {
+            plan.scheduled[i]->evaluate();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (!failure) failure = std::current_exception();
+        }
+
+        for (size_t consumer : plan.consumers[i]) {
+            if (--waitingOn[consumer] == 0) {
+                pool->submit([&run, consumer] { run(consumer); });
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (--remaining == 0) doneSignal.notify_all();
+    };
+
+    for (size_t i = 0; i < count; i++) {
+        if (plan.inputCount[i] == 0) {
+            pool->submit([&run, i] { run(i); });
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneSignal.wait(lock, [&] { return remaining == 0; });
+    if (failure) std::rethrow_exception(failure);
+}
+
+void GraphExecutor::balanceOpenCVThreads(int parallelWidth) {
+    // OpenCV parallelises inside filter2D, cvtColor and friends with its own
+    // threads. Split the cores between the nodes that can run concurrently so
+    // that wide graphs do not oversubscribe them, while a single chain still
+    // gets every core inside each call.
+    int cores = std::max(1, cv::getNumberOfCPUs());
+    int concurrentNodes = std::max(1, std::min(parallelWidth, static_cast<int>(pool->size())));
+    int threads = std::max(1, cores / concurrentNodes);
+
+    if (threads != openCVThreads) {
+        cv::setNumThreads(threads);
+        openCVThreads = threads;
+    }
+}
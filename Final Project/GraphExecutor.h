@@ -0,0 +1,113 @@
+#pragma once
+#include "Node.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class ThreadPool;
+class MemoryBudget;
+
+// Evaluates the node graph in dependency order, following Node::inputs.
+// Every node that is dirty, or whose inputs produced a newer result than the one
+// it last consumed, runs exactly once, so a chain of any length settles in a
+// single call.
+//
+// With a thread pool, every node whose inputs are ready is dispatched at once, so
+// independent branches run on separate cores.
+//
+// Evaluation is split in two halves: plan() reads the wiring and dirty flags and
+// must be called on the UI thread, run() only calls process() and may be called
+// from any thread while the UI keeps editing the graph.
+//
+// Evaluation is pulled from the nodes whose results are requested (the Output
+// node and visible previews in the editor): only they and the nodes they read
+// from, directly or not, are planned. Everything else stays stale, and dirty,
+// until something asks for it.
+//
+// With in-place execution enabled, a node that only feeds a single consumer
+// hands its result over instead of keeping it (see Node::takeInput). That halves
+// the memory of long chains but means the node recomputes whenever its result is
+// needed again, so it suits one-shot passes such as nodebatch rather than
+// interactive editing, where every intermediate is reused across edits.
+//
+// With tiled execution, which is also for one-shot passes, a chain of nodes
+// that each read a fixed window of a single input (see Node::footprint), and
+// whose intermediate results nobody wants, runs as one job over cache-sized
+// tiles. Each tile carries the halo the nodes after it need, so the result
+// matches evaluating the chain whole, without writing any intermediate image
+// out to memory.
+//
+// A requested node that only shows part of its result (Node::viewRegion, a
+// zoomed preview in the editor) asks for just that region. The region travels
+// back towards the sources, growing by each node's footprint, for as long as
+// the nodes can compute a part of their result; those jobs then only compute
+// what is needed downstream, so inspecting a crop of a huge image costs about
+// as much as the crop. Results are kept until they no longer cover what is
+// needed.
+//
+// With a MemoryBudget, each plan first evicts results until the graph fits in
+// it; evicted results are recomputed by the plans that need them.
+//
+// With a proxy scale above 1 the planned nodes run on a 1/scale proxy of their
+// sources (see Node::jobScale), which the editor uses while a slider is being
+// dragged. Every node whose result was made at another scale runs again, so
+// going back to 1 refines the whole graph at full resolution.
+//
+// With progressive rendering, which is for the editor, full resolution jobs
+// publish partial results as they go (see Node::progressive).
+class GraphExecutor {
+public:
+    struct Plan {
+        std::vector<Node*> scheduled;                 // topological order
+        std::vector<std::vector<size_t>> consumers;   // indices into scheduled
+        std::vector<int> inputCount;                  // scheduled inputs per node
+        int width = 0;                                // widest level of the graph
+
+        bool empty() const { return scheduled.empty(); }
+    };
+
+    explicit GraphExecutor(ThreadPool* pool = nullptr) : pool(pool) {}
+
+    void evaluate(const std::vector<Node*>& nodes) { run(plan(nodes)); }
+    void evaluate(const std::vector<Node*>& nodes, const std::vector<Node*>& requested) {
+        run(plan(nodes, requested));
+    }
+
+    Plan plan(const std::vector<Node*>& nodes) { return plan(nodes, nodes); }
+    Plan plan(const std::vector<Node*>& nodes, const std::vector<Node*>& requested);
+    void run(const Plan& plan);
+
+    void setInPlace(bool enabled) { inPlace = enabled; }
+    void setTiled(bool enabled) { tiled = enabled; }
+    void setMemoryBudget(MemoryBudget* budget) { memoryBudget = budget; }
+    void setProxyScale(int scale) { proxyScale = std::max(1, scale); }
+    int getProxyScale() const { return proxyScale; }
+    void setProgressive(bool enabled) { progressive = enabled; }
+
+    // Orders nodes so that each one comes after all of its inputs (Kahn's algorithm).
+    // Nodes that sit on, or depend on, a cycle cannot be ordered; they are left out
+    // of the result and written to cyclic if it is given.
+    static std::vector<Node*> topologicalOrder(const std::vector<Node*>& nodes,
+                                               std::vector<Node*>* cyclic = nullptr);
+
+    // The requested nodes plus everything they read from, directly or through other nodes
+    static std::unordered_set<Node*> upstreamOf(const std::vector<Node*>& requested);
+
+    const std::vector<Node*>& getCycleNodes() const { return cycleNodes; }
+
+private:
+    ThreadPool* pool;
+    std::vector<Node*> cycleNodes;
+    int openCVThreads = -1;
+    bool inPlace = false;
+    bool tiled = false;
+    MemoryBudget* memoryBudget = nullptr;
+    int proxyScale = 1;
+    bool progressive = false;
+
+    void prepareJob(Node* node);
+    void assignRegions(const std::vector<Node*>& order, const std::unordered_set<Node*>& wanted,
+                       const std::unordered_map<Node*, size_t>& position, std::vector<char>& runs);
+    void runParallel(const Plan& plan);
+    void balanceOpenCVThreads(int parallelWidth);
+};
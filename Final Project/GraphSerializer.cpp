@@ -0,0 +1,475 @@
+#include "GraphSerializer.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+const int FORMAT_VERSION = 1;
+const char BINARY_MAGIC[4] = {'N', 'G', 'R', 'B'};
+
+// Writes each visited field as a "param" line
+class TextWriter : public ParamVisitor {
+public:
+    TextWriter(std::ostream& out, int id) : out(out), id(id) {}
+
+    void field(const char* name, int& value) override { begin(name) << value << '\n'; }
+    void field(const char* name, float& value) override {
+        begin(name) << std::setprecision(std::numeric_limits<float>::max_digits10) << value << '\n';
+    }
+    void field(const char* name, double& value) override {
+        begin(name) << std::setprecision(std::numeric_limits<double>::max_digits10) << value << '\n';
+    }
+    void field(const char* name, bool& value) override { begin(name) << (value ? 1 : 0) << '\n'; }
+    void field(const char* name, std::string& value) override { begin(name) << std::quoted(value) << '\n'; }
+    void field(const char* name, std::vector<float>& value) override {
+        std::ostream& line = begin(name) << value.size();
+        line << std::setprecision(std::numeric_limits<float>::max_digits10);
+        for (float element : value) line << ' ' << element;
+        line << '\n';
+    }
+
+private:
+    std::ostream& out;
+    int id;
+
+    std::ostream& begin(const char* name) { return out << "param " << id << ' ' << name << ' '; }
+};
+
+// Fills visited fields from the "param" lines read for one node
+class TextReader : public ParamVisitor {
+public:
+    struct Value {
+        std::string text;
+        int line;
+    };
+
+    explicit TextReader(const std::map<std::string, Value>& values) : values(values) {}
+
+    void field(const char* name, int& value) override { read(name, value); }
+    void field(const char* name, float& value) override { read(name, value); }
+    void field(const char* name, double& value) override { read(name, value); }
+    void field(const char* name, bool& value) override {
+        int flag = value ? 1 : 0;
+        read(name, flag);
+        value = flag != 0;
+    }
+    void field(const char* name, std::string& value) override {
+        std::istringstream in;
+        if (open(name, in)) {
+            in >> std::quoted(value);
+            check(name, in);
+        }
+    }
+    void field(const char* name, std::vector<float>& value) override {
+        std::istringstream in;
+        if (!open(name, in)) return;
+
+        size_t count = 0;
+        in >> count;
+        // Every element takes at least a space and a digit, so a count beyond
+        // that comes from a damaged file and must not size the vector
+        size_t remaining = in.good() ? values.at(name).text.size() - static_cast<size_t>(in.tellg()) : 0;
+        if (count > remaining / 2) in.setstate(std::ios::failbit);
+        check(name, in);
+        std::vector<float> elements(count);
+        for (float& element : elements) in >> element;
+        check(name, in);
+        value = std::move(elements);
+    }
+
+private:
+    const std::map<std::string, Value>& values;
+
+    bool open(const char* name, std::istringstream& in) {
+        auto it = values.find(name);
+        if (it == values.end()) return false;
+        in.str(it->second.text);
+        return true;
+    }
+
+    template <typename T>
+    void read(const char* name, T& value) {
+        std::istringstream in;
+        if (open(name, in)) {
+            in >> value;
+            check(name, in);
+        }
+    }
+
+    void check(const char* name, std::istringstream& in) {
+        if (in.fail()) {
+            throw std::runtime_error("graph line " + std::to_string(values.at(name).line) +
+                                     ": bad value for " + name);
+        }
+    }
+};
+
+// Binary payload type of each field
+enum class Tag : uint8_t { Int, Float, Double, Bool, String, FloatVector };
+
+// Appends each visited field as name, tag and value
+class BinaryWriter : public ParamVisitor {
+public:
+    explicit BinaryWriter(std::string& out) : out(out) {}
+
+    uint32_t count = 0;
+
+    void field(const char* name, int& value) override { put(name, Tag::Int, static_cast<int32_t>(value)); }
+    void field(const char* name, float& value) override { put(name, Tag::Float, value); }
+    void field(const char* name, double& value) override { put(name, Tag::Double, value); }
+    void field(const char* name, bool& value) override { put(name, Tag::Bool, static_cast<uint8_t>(value)); }
+    void field(const char* name, std::string& value) override {
+        begin(name, Tag::String);
+        putString(out, value);
+    }
+    void field(const char* name, std::vector<float>& value) override {
+        begin(name, Tag::FloatVector);
+        putRaw(out, static_cast<uint32_t>(value.size()));
+        out.append(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(float));
+    }
+
+    template <typename T>
+    static void putRaw(std::string& out, T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    static void putString(std::string& out, const std::string& value) {
+        putRaw(out, static_cast<uint32_t>(value.size()));
+        out.append(value);
+    }
+
+private:
+    std::string& out;
+
+    void begin(const char* name, Tag tag) {
+        putString(out, name);
+        putRaw(out, tag);
+        count++;
+    }
+    template <typename T>
+    void put(const char* name, Tag tag, T value) {
+        begin(name, tag);
+        putRaw(out, value);
+    }
+};
+
+// Bounds-checked cursor over a binary graph held in memory
+class BinaryCursor {
+public:
+    BinaryCursor(const char* data, size_t size) : data(data), size(size) {}
+
+    template <typename T>
+    T raw() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+    std::string string() {
+        uint32_t length = raw<uint32_t>();
+        return std::string(take(length), length);
+    }
+    const char* take(size_t bytes) {
+        if (bytes > size - offset) throw std::runtime_error("binary graph: truncated at byte " + std::to_string(offset));
+        const char* at = data + offset;
+        offset += bytes;
+        return at;
+    }
+
+private:
+    const char* data;
+    size_t size;
+    size_t offset = 0;
+};
+
+// Fills visited fields from the params stored for one node
+class BinaryReader : public ParamVisitor {
+public:
+    struct Value {
+        std::string name;
+        Tag tag;
+        const char* payload;
+        size_t size;
+    };
+
+    explicit BinaryReader(const std::vector<Value>& values) : values(values) {}
+
+    void field(const char* name, int& value) override {
+        if (const Value* v = find(name, Tag::Int)) value = cursor(*v).raw<int32_t>();
+    }
+    void field(const char* name, float& value) override {
+        if (const Value* v = find(name, Tag::Float)) value = cursor(*v).raw<float>();
+    }
+    void field(const char* name, double& value) override {
+        if (const Value* v = find(name, Tag::Double)) value = cursor(*v).raw<double>();
+    }
+    void field(const char* name, bool& value) override {
+        if (const Value* v = find(name, Tag::Bool)) value = cursor(*v).raw<uint8_t>() != 0;
+    }
+    void field(const char* name, std::string& value) override {
+        if (const Value* v = find(name, Tag::String)) value = cursor(*v).string();
+    }
+    void field(const char* name, std::vector<float>& value) override {
+        if (const Value* v = find(name, Tag::FloatVector)) {
+            BinaryCursor in = cursor(*v);
+            uint32_t count = in.raw<uint32_t>();
+            const char* elements = in.take(size_t(count) * sizeof(float));
+            value.resize(count);
+            std::memcpy(value.data(), elements, size_t(count) * sizeof(float));
+        }
+    }
+
+private:
+    const std::vector<Value>& values;
+
+    static BinaryCursor cursor(const Value& value) { return BinaryCursor(value.payload, value.size); }
+
+    // Nodes have a handful of fields, a linear scan beats any map here
+    const Value* find(const char* name, Tag tag) const {
+        for (const Value& value : values) {
+            if (value.name == name) {
+                if (value.tag != tag) throw std::runtime_error(std::string("binary graph: wrong type for ") + name);
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// Size of a tagged payload, so the reader can skip to the next field
+size_t payloadSize(Tag tag, BinaryCursor peek) {
+    switch (tag) {
+        case Tag::Int: return sizeof(int32_t);
+        case Tag::Float: return sizeof(float);
+        case Tag::Double: return sizeof(double);
+        case Tag::Bool: return sizeof(uint8_t);
+        case Tag::String: return sizeof(uint32_t) + peek.raw<uint32_t>();
+        case Tag::FloatVector: return sizeof(uint32_t) + size_t(peek.raw<uint32_t>()) * sizeof(float);
+    }
+    throw std::runtime_error("binary graph: unknown field type " + std::to_string(static_cast<int>(tag)));
+}
+
+// Creates nodes as a file declares them and wires the edges once all exist
+class GraphBuilder {
+public:
+    explicit GraphBuilder(const NodeFactory& factory) : factory(factory) {}
+
+    Node* addNode(int id, const std::string& type, const std::string& where) {
+        if (byId.count(id)) throw std::runtime_error(where + ": duplicate node id " + std::to_string(id));
+        std::unique_ptr<Node> node = factory.create(type, id);
+        if (!node) throw std::runtime_error(where + ": unknown node type " + type);
+        byId[id] = node.get();
+        nodes.push_back(std::move(node));
+        return nodes.back().get();
+    }
+
+    Node* find(int id) const {
+        auto it = byId.find(id);
+        return it == byId.end() ? nullptr : it->second;
+    }
+
+    void addEdge(int node, int slot, int source, const std::string& where) {
+        edges.push_back({node, slot, source, where});
+    }
+
+    GraphSerializer::NodeList finish() {
+        for (const Edge& edge : edges) {
+            Node* consumer = find(edge.node);
+            Node* source = find(edge.source);
+            if (!consumer || !source) throw std::runtime_error(edge.where + ": edge references an undeclared node");
+            if (edge.slot < 0 || edge.slot >= static_cast<int>(consumer->inputs.size())) {
+                throw std::runtime_error(edge.where + ": node " + std::to_string(edge.node) +
+                                         " has no input slot " + std::to_string(edge.slot));
+            }
+            consumer->setInput(edge.slot, source);
+        }
+        return std::move(nodes);
+    }
+
+private:
+    struct Edge {
+        int node, slot, source;
+        std::string where;
+    };
+
+    const NodeFactory& factory;
+    GraphSerializer::NodeList nodes;
+    std::unordered_map<int, Node*> byId;
+    std::vector<Edge> edges;
+};
+
+std::string lineName(int line) {
+    return "graph line " + std::to_string(line);
+}
+}
+
+void GraphSerializer::saveText(std::ostream& out, const std::vector<Node*>& nodes) {
+    out << "nodegraph " << FORMAT_VERSION << '\n';
+    for (Node* node : nodes) {
+        out << "node " << node->id << ' ' << node->typeName() << '\n';
+        TextWriter writer(out, node->id);
+        node->visitParams(writer);
+    }
+    for (Node* node : nodes) {
+        for (size_t slot = 0; slot < node->inputs.size(); slot++) {
+            if (node->inputs[slot]) {
+                out << "input " << node->id << ' ' << slot << ' ' << node->inputs[slot]->id << '\n';
+            }
+        }
+    }
+}
+
+GraphSerializer::NodeList GraphSerializer::loadText(std::istream& in, const NodeFactory& factory) {
+    GraphBuilder builder(factory);
+    std::vector<std::pair<Node*, std::map<std::string, TextReader::Value>>> params;
+
+    std::string text;
+    int lineNumber = 0;
+    bool sawHeader = false;
+    while (std::getline(in, text)) {
+        lineNumber++;
+        if (!text.empty() && text.back() == '\r') text.pop_back();
+
+        std::istringstream line(text);
+        std::string keyword;
+        if (!(line >> keyword) || keyword[0] == '#') continue;
+
+        auto fail = [&](const std::string& message) { throw std::runtime_error(lineName(lineNumber) + ": " + message); };
+        if (!sawHeader) {
+            int version = 0;
+            if (keyword != "nodegraph" || !(line >> version)) fail("expected 'nodegraph <version>'");
+            if (version > FORMAT_VERSION) fail("unsupported version " + std::to_string(version));
+            sawHeader = true;
+        } else if (keyword == "node") {
+            int id;
+            std::string type;
+            if (!(line >> id >> type)) fail("expected 'node <id> <type>'");
+            params.push_back({builder.addNode(id, type, lineName(lineNumber)), {}});
+        } else if (keyword == "param") {
+            int id;
+            std::string name;
+            if (!(line >> id >> name)) fail("expected 'param <id> <name> <value>'");
+            auto entry = std::find_if(params.begin(), params.end(), [id](const auto& p) { return p.first->id == id; });
+            if (entry == params.end()) fail("param for undeclared node " + std::to_string(id));
+
+            std::string value;
+            std::getline(line >> std::ws, value);
+            entry->second[name] = {value, lineNumber};
+        } else if (keyword == "input") {
+            int node, slot, source;
+            if (!(line >> node >> slot >> source)) fail("expected 'input <id> <slot> <source id>'");
+            builder.addEdge(node, slot, source, lineName(lineNumber));
+        } else {
+            fail("unknown statement '" + keyword + "'");
+        }
+    }
+    if (!sawHeader) throw std::runtime_error(lineName(lineNumber) + ": missing 'nodegraph' header");
+
+    for (auto& [node, values] : params) {
+        TextReader reader(values);
+        node->visitParams(reader);
+        node->paramsLoaded();
+    }
+    return builder.finish();
+}
+
+void GraphSerializer::saveBinary(std::ostream& out, const std::vector<Node*>& nodes) {
+    std::string buffer(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    BinaryWriter::putRaw(buffer, static_cast<uint32_t>(FORMAT_VERSION));
+    BinaryWriter::putRaw(buffer, static_cast<uint32_t>(nodes.size()));
+
+    uint32_t edgeCount = 0;
+    for (Node* node : nodes) {
+        BinaryWriter::putRaw(buffer, static_cast<int32_t>(node->id));
+        BinaryWriter::putString(buffer, node->typeName());
+
+        std::string fields;
+        BinaryWriter writer(fields);
+        node->visitParams(writer);
+        BinaryWriter::putRaw(buffer, writer.count);
+        buffer += fields;
+
+        edgeCount += static_cast<uint32_t>(std::count_if(node->inputs.begin(), node->inputs.end(),
+                                                         [](Node* input) { return input != nullptr; }));
+    }
+
+    BinaryWriter::putRaw(buffer, edgeCount);
+    for (Node* node : nodes) {
+        for (size_t slot = 0; slot < node->inputs.size(); slot++) {
+            if (node->inputs[slot]) {
+                BinaryWriter::putRaw(buffer, static_cast<int32_t>(node->id));
+                BinaryWriter::putRaw(buffer, static_cast<int32_t>(slot));
+                BinaryWriter::putRaw(buffer, static_cast<int32_t>(node->inputs[slot]->id));
+            }
+        }
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+GraphSerializer::NodeList GraphSerializer::loadBinary(const char* data, size_t size, const NodeFactory& factory) {
+    BinaryCursor in(data, size);
+    if (std::memcmp(in.take(sizeof(BINARY_MAGIC)), BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+        throw std::runtime_error("binary graph: bad magic");
+    }
+    uint32_t version = in.raw<uint32_t>();
+    if (version > FORMAT_VERSION) throw std::runtime_error("binary graph: unsupported version " + std::to_string(version));
+
+    GraphBuilder builder(factory);
+    std::vector<BinaryReader::Value> values;
+    uint32_t nodeCount = in.raw<uint32_t>();
+    for (uint32_t n = 0; n < nodeCount; n++) {
+        int id = in.raw<int32_t>();
+        Node* node = builder.addNode(id, in.string(), "binary graph");
+
+        values.clear();
+        uint32_t fieldCount = in.raw<uint32_t>();
+        for (uint32_t f = 0; f < fieldCount; f++) {
+            std::string name = in.string();
+            Tag tag = in.raw<Tag>();
+            size_t bytes = payloadSize(tag, in);
+            values.push_back({std::move(name), tag, in.take(bytes), bytes});
+        }
+        BinaryReader reader(values);
+        node->visitParams(reader);
+        node->paramsLoaded();
+    }
+
+    uint32_t edgeCount = in.raw<uint32_t>();
+    for (uint32_t e = 0; e < edgeCount; e++) {
+        int node = in.raw<int32_t>();
+        int slot = in.raw<int32_t>();
+        int source = in.raw<int32_t>();
+        builder.addEdge(node, slot, source, "binary graph");
+    }
+    return builder.finish();
+}
+
+GraphSerializer::NodeList GraphSerializer::load(std::istream& in, const NodeFactory& factory) {
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (contents.compare(0, sizeof(BINARY_MAGIC), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0) {
+        return loadBinary(contents.data(), contents.size(), factory);
+    }
+    std::istringstream text(contents);
+    return loadText(text, factory);
+}
+
+void GraphSerializer::saveFile(const std::string& path, const std::vector<Node*>& nodes, Format format) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("cannot write " + path);
+    if (format == Format::Binary) {
+        saveBinary(out, nodes);
+    } else {
+        saveText(out, nodes);
+    }
+}
+
+GraphSerializer::NodeList GraphSerializer::loadFile(const std::string& path, const NodeFactory& factory) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot read " + path);
+    return load(in, factory);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include "Node.h"
+#include "NodeFactory.h"
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Saves and loads a node graph: node types, ids, parameters and edges.
+//
+// The text form has one statement per line, '#' starts a comment:
+//
+//   nodegraph 1
+//   node 4 BlurNode
+//   param 4 radius 5
+//   param 1 filePath "C:/images/in.png"
+//   param 9 kernel 9 0 -1 0 -1 5 -1 0 -1 0    (vectors: count, then values)
+//   input 4 0 1                               (node 4, slot 0 reads node 1)
+//
+// The binary form holds the same information for servers that instantiate
+// pipelines at high rates: a "NGRB" magic and version, then per node its id,
+// type and tagged fields, then the edges. Integers are 32-bit and all values
+// are stored in the host's (little-endian) byte order.
+//
+// Parameters a node does not know are ignored, and parameters missing from the
+// file keep their defaults, so files survive nodes gaining or losing fields.
+// Malformed files throw std::runtime_error naming the offending line or byte.
+class GraphSerializer {
+public:
+    using NodeList = std::vector<std::unique_ptr<Node>>;
+    enum class Format { Text, Binary };
+
+    static void saveText(std::ostream& out, const std::vector<Node*>& nodes);
+    static NodeList loadText(std::istream& in, const NodeFactory& factory);
+
+    static void saveBinary(std::ostream& out, const std::vector<Node*>& nodes);
+    static NodeList loadBinary(const char* data, size_t size, const NodeFactory& factory);
+
+    // Reads either form, telling them apart by the binary magic
+    static NodeList load(std::istream& in, const NodeFactory& factory);
+
+    static void saveFile(const std::string& path, const std::vector<Node*>& nodes, Format format = Format::Text);
+    static NodeList loadFile(const std::string& path, const NodeFactory& factory);
+};
\ No newline at end of file
@@ -1,23 +1,40 @@
 #pragma once
 #include "Node.h"
+#include "ResultSlot.h"
 #include <string>
-#include <GL/glew.h>
 #include <opencv2/opencv.hpp>
 
 class LoadImageNode : public Node {
 public:
+    struct Params {
+        std::string filePath;
+
+        auto tie() const { return std::tie(filePath); }
+        bool operator==(const Params& other) const { return tie() == other.tie(); }
+        size_t hash() const { return hashTuple(tie()); }
+        void visit(ParamVisitor& v) {
+            v.field("filePath", filePath);
+        }
+    };
+
     LoadImageNode(int id);
-    void drawUI() override;
     void process() override;
-    cv::Mat getOutput() const override;
-    
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return image.take(); }
+    size_t paramsHash() const override { return jobParams.hash(); }
+    const char* typeName() const override { return "LoadImageNode"; }
+    void visitParams(ParamVisitor& v) override { params.visit(v); }
+
+    Params params;  // edited by the UI
+
 
+protected:
+    ResultSlot<Frame> image;
 
 private:
-    std::string filePath;
-    cv::Mat image;
-    GLuint texture = 0;
-    GLuint matToTexture(const cv::Mat& mat);
-    char filepath[256] = "";
-    GLuint textureID;
+    Params jobParams;  // snapshot read by process()
+    std::string resultPath;  // file the current result was read from
+    Frame decoded;           // full resolution pixels of decodedPath, kept while running on a proxy
+    std::string decodedPath;
+    void captureParams() override { jobParams = params; }
 };
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "LoadImageNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+#include "tinyfiledialogs.h"
+
+void LoadImageNodeUI::drawUI() {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
+    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom right
+
+    // Gradient colors
+    ImVec4 color1 = ImVec4(54.0f / 255.0f, 69.0f / 255.0f, 79.0f / 255.0f, 1.0f);
+    ImVec4 color2 = ImVec4(25.0f / 255.0f, 25.0f / 255.0f, 112.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),  // top left to top right
+        ImColor(color2), ImColor(color2)); // bottom left to bottom right
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0); // reset cursor so the button is placed correctly
+    if (ImGui::Button("Choose Image")) {
+        const char* filters[] = { "*.jpg", "*.png", "*.bmp" };
+        const char* selected = tinyfd_openFileDialog(
+            "Open Image",
+            "",
+            3,
+            filters,
+            "Image files",
+            0
+        );
+
+        if (selected) {
+            params.filePath = selected;
+            markDirty();
+        }
+    }
+
+    resultPreview.drawResult("Preview:", *this);
+}
\ No newline at end of file
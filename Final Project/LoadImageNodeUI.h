@@ -0,0 +1,16 @@
+#pragma once
+#include "LoadImageNode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for LoadImageNode: file picker and preview texture
+class LoadImageNodeUI : public LoadImageNode {
+public:
+    using LoadImageNode::LoadImageNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage resultPreview{this, 0, ImVec2(300, 300)};
+};
@@ -0,0 +1,62 @@
+#include "MemoryBudget.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+struct Buffer {
+    size_t bytes = 0;
+    int holders = 0;  // nodes whose results reference it
+};
+}
+
+void MemoryBudget::enforce(const std::vector<Node*>& nodes, const std::vector<Node*>& requested) {
+    std::unordered_map<const cv::UMatData*, Buffer> buffers;
+    std::vector<std::vector<const cv::UMatData*>> held(nodes.size());
+    std::vector<size_t> heldBytes(nodes.size(), 0);
+
+    resident = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        for (const Frame& result : nodes[i]->results()) {
+            const cv::UMatData* u = result.buffer();
+            if (!u || std::find(held[i].begin(), held[i].end(), u) != held[i].end()) continue;
+
+            held[i].push_back(u);
+            heldBytes[i] += u->size;
+            Buffer& buffer = buffers[u];
+            if (buffer.holders++ == 0) {
+                buffer.bytes = u->size;
+                resident += u->size;
+            }
+        }
+    }
+    peakResident = std::max(peakResident, resident);
+    if (budget == 0 || resident <= budget) return;
+
+    std::unordered_set<Node*> wanted(requested.begin(), requested.end());
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        Node* node = nodes[i];
+        if (heldBytes[i] == 0 || node->outputReleased || wanted.count(node)) continue;
+
+        bool readSoon = std::any_of(node->outputs.begin(), node->outputs.end(),
+                                    [](Node* consumer) { return consumer->needsUpdate(); });
+        if (readSoon && !node->dirty) continue;
+        candidates.push_back(i);
+    }
+
+    // Cheapest seconds of recomputation per byte freed first
+    auto cost = [&](size_t i) { return nodes[i]->dirty ? 0.0 : nodes[i]->lastRunSeconds / heldBytes[i]; };
+    std::sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) { return cost(a) < cost(b); });
+
+    for (size_t i : candidates) {
+        if (resident <= budget) break;
+
+        nodes[i]->evict();
+        evicted++;
+        for (const cv::UMatData* u : held[i]) {
+            Buffer& buffer = buffers[u];
+            if (--buffer.holders == 0) resident -= buffer.bytes;
+        }
+    }
+}
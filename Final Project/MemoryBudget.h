@@ -0,0 +1,36 @@
+#pragma once
+#include "Node.h"
+#include <cstddef>
+#include <vector>
+
+// Keeps the results held by the graph under a byte budget. Memory is counted
+// per buffer, so nodes that share one (the Output node and its input, a channel
+// and the selected channel) are only charged once.
+//
+// Over budget, the results that are cheapest to recompute for the memory they
+// hold go first: stale results of dirty nodes cost nothing, the others cost the
+// time their process() took. An evicted node runs again, from the same
+// parameters and inputs, once a plan needs its result (see GraphExecutor).
+// Results of requested nodes are never evicted, nor are those whose consumers
+// are about to run and would read them straight back.
+class MemoryBudget {
+public:
+    explicit MemoryBudget(size_t budgetBytes = 0) : budget(budgetBytes) {}
+
+    void setBudget(size_t bytes) { budget = bytes; }  // 0: unlimited
+    size_t getBudget() const { return budget; }
+
+    // Measures the results of nodes and evicts until they fit. Runs on the UI
+    // thread between passes, from GraphExecutor::plan().
+    void enforce(const std::vector<Node*>& nodes, const std::vector<Node*>& requested);
+
+    size_t residentBytes() const { return resident; }  // as of the last enforce()
+    size_t peakResidentBytes() const { return peakResident; }
+    size_t evictions() const { return evicted; }
+
+private:
+    size_t budget;
+    size_t resident = 0;
+    size_t peakResident = 0;
+    size_t evicted = 0;
+};
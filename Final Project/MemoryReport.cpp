@@ -0,0 +1,44 @@
+#include "MemoryReport.h"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+size_t MemoryReport::resultBytes(const Node& node) {
+    std::vector<const cv::UMatData*> seen;
+    size_t bytes = 0;
+    for (const Frame& result : node.results()) {
+        const cv::UMatData* u = result.buffer();
+        if (!u || std::find(seen.begin(), seen.end(), u) != seen.end()) continue;
+        seen.push_back(u);
+        bytes += u->size;
+    }
+    return bytes;
+}
+
+std::vector<MemoryReport::Entry> MemoryReport::collect(const std::vector<Node*>& nodes) {
+    std::vector<Entry> entries;
+    entries.reserve(nodes.size());
+    for (const Node* node : nodes) {
+        Entry entry;
+        entry.node = node;
+        entry.resultBytes = resultBytes(*node);
+        entry.cacheBytes = node->cacheBytes();
+        entry.textureBytes = node->textureBytes();
+        entry.lastPeakBytes = node->lastPeakBytes;
+        entry.highWaterBytes = node->highWaterBytes;
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+void MemoryReport::print(std::ostream& out, const std::vector<Entry>& entries) {
+    auto mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+    out << std::fixed << std::setprecision(1);
+    out << std::left << std::setw(24) << "node" << std::right << std::setw(10) << "results" << std::setw(10) << "caches"
+        << std::setw(10) << "textures" << std::setw(10) << "peak" << std::setw(12) << "high-water" << "  (MB)\n";
+    for (const Entry& entry : entries) {
+        out << std::left << std::setw(24) << entry.node->getName() << std::right << std::setw(10) << mb(entry.resultBytes)
+            << std::setw(10) << mb(entry.cacheBytes) << std::setw(10) << mb(entry.textureBytes) << std::setw(10)
+            << mb(entry.lastPeakBytes) << std::setw(12) << mb(entry.highWaterBytes) << "\n";
+    }
+}
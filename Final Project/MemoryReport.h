@@ -0,0 +1,33 @@
+#pragma once
+#include "Node.h"
+#include <iosfwd>
+#include <vector>
+
+// Per-node memory, for the editor's Graph window and for headless tools that
+// size machines or watch for regressions:
+//
+//   for (const auto& entry : MemoryReport::collect(nodes)) ...
+//
+// Results count every buffer a node's results() reference, so a buffer shared
+// between nodes (the Output node and its input) shows up under each of them.
+// Textures are only held by the editor's *NodeUI classes.
+class MemoryReport {
+public:
+    struct Entry {
+        const Node* node = nullptr;
+        size_t resultBytes = 0;
+        size_t cacheBytes = 0;
+        size_t textureBytes = 0;
+        size_t lastPeakBytes = 0;   // transient peak of the last process()
+        size_t highWaterBytes = 0;  // highest transient peak so far
+
+        size_t heldBytes() const { return resultBytes + cacheBytes + textureBytes; }
+    };
+
+    // Call on the UI thread, or between passes
+    static std::vector<Entry> collect(const std::vector<Node*>& nodes);
+    static size_t resultBytes(const Node& node);
+
+    // One line per node, in MB
+    static void print(std::ostream& out, const std::vector<Entry>& entries);
+};
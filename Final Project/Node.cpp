@@ -0,0 +1,94 @@
+#include "Node.h"
+#include "TileGrid.h"
+#include <algorithm>
+
+namespace {
+// Side of the tiles a chain runs on: four of its buffers, with their halos,
+// stay within a typical 1 MB L2. Chains with wide halos get larger tiles so
+// that recomputing the halos stays a small part of the work.
+constexpr int CHAIN_TILE_SIZE = 128;
+}
+
+void Node::processTiles() {
+    std::vector<Node*> chain = tileChain;
+    chain.push_back(this);
+
+    ImageView source = chain.front()->takeInput(0).view();
+    if (source.empty()) {
+        process();  // sees the chain's empty results, as it would untiled
+        return;
+    }
+    cv::Rect image(0, 0, source.cols(), source.rows());
+
+    int halo = 0;
+    for (Node* node : chain) {
+        halo += node->footprint() / 2;
+        node->beginTiles(source.size());
+    }
+    std::vector<cv::Rect> tiles = TileGrid::tiles(source.size(), std::max(CHAIN_TILE_SIZE, 4 * halo));
+
+    auto chainCancelled = [&] {
+        return std::any_of(chain.begin(), chain.end(), [](Node* node) { return node->cancelled(); });
+    };
+
+    // Each node computes the tile grown by the footprints of the nodes after
+    // it, so the last one has every pixel it reads. Away from the image edges
+    // the filters then extrapolate only into pixels that are thrown away; at
+    // the edges they extrapolate exactly as they would on the whole image.
+    auto renderTile = [&](const cv::Rect& tile) {
+        std::vector<cv::Rect> areas(chain.size());
+        areas.back() = tile;
+        for (size_t i = chain.size() - 1; i > 0; i--) {
+            areas[i - 1] = TileGrid::grow(areas[i], chain[i]->footprint() / 2) & image;
+        }
+
+        cv::Rect inputArea = TileGrid::grow(areas.front(), chain.front()->footprint() / 2) & image;
+        ImageView part = source(inputArea);
+        cv::Mat rendered;
+        for (size_t i = 0; i < chain.size() && !part.empty(); i++) {
+            rendered = chain[i]->processTile(part, inputArea, areas[i]);
+            part = ImageView(rendered);
+            inputArea = areas[i];
+        }
+        return rendered;
+    };
+
+    // The first tile tells the type of the result
+    cv::Mat first = renderTile(tiles.front());
+    if (first.empty() || chainCancelled()) return;
+    cv::Mat result(source.size(), first.type());
+    cv::Mat firstTarget = result(tiles.front());
+    first.copyTo(firstTarget);
+
+    cv::parallel_for_(cv::Range(1, static_cast<int>(tiles.size())), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++) {
+            if (chainCancelled()) return;
+            cv::Mat part = renderTile(tiles[i]);
+            cv::Mat target = result(tiles[i]);
+            if (!part.empty()) part.copyTo(target);
+        }
+    });
+    if (chainCancelled()) return;
+    publishTiles(Frame(std::move(result), jobScale));
+}
+
+void Node::processRegion() {
+    Frame inputFrame = takeInput(0);
+    if (inputFrame.empty()) {
+        publishTiles(Frame());  // Clear output if no input is connected or it is empty
+        return;
+    }
+
+    // The input holds all of the image, or a region of it at least as large
+    // as this one grown by the footprint (the executor asked it for that)
+    cv::Size size = inputFrame.imageSize();
+    cv::Rect area = jobRegion & cv::Rect(0, 0, size.width, size.height);
+
+    cv::Mat result;
+    if (!area.empty()) {
+        beginTiles(size);
+        result = processTile(inputFrame.view(), inputFrame.area(), area);
+    }
+    if (cancelled()) return;
+    publishTiles(Frame(std::move(result), area, size, jobScale));
+}
\ No newline at end of file
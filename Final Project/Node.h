@@ -4,46 +4,332 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include "AllocationScope.h"
+#include "Frame.h"
+#include "FrameArena.h"
+#include "ParamHash.h"
+#include "ParamVisitor.h"
+#include "ResultSlot.h"
 
 class Node {
 public:
     int id;
     std::string name;
     std::vector<Node*> inputs;
-    std::vector<Node*> outputs;
+    std::vector<Node*> outputs;   // consumers, kept in sync by setInput()
     bool dirty = true;
     bool firstTimeDrawingGradient = true;
 
+    // Bumped every time the node produces a new result. inputGenerations holds
+    // the generation of each input as it was when this node last ran.
+    std::atomic<uint64_t> generation{0};
+    std::vector<uint64_t> inputGenerations;
+    size_t lastJobKey = 0;  // hash of the parameters and inputs of the last result
+
+    // Raised when the node is edited while its job is in flight. That job's
+    // result is already stale, so kernels poll cancelled() between rows and
+    // give up early, leaving the CPU to the job for the latest value.
+    std::atomic<bool> cancelRequested{false};
+
+    // Inputs as they were wired when the running evaluation was planned.
+    // process() reads these so the UI can rewire inputs while it runs.
+    std::vector<Node*> boundInputs;
+
+    // Set by the executor when this node's only consumer may take over its
+    // result instead of sharing it (see takeInput). outputReleased records that
+    // it did: the result is gone and the node has to run again before anything
+    // else can read it.
+    bool donatesOutput = false;
+    bool outputReleased = false;
+    bool recomputing = false;  // this job only restores a released result
+
+    std::atomic<double> lastRunSeconds{0};  // time process() took for the current result
+
+    // Resolution the job runs at and the current result was made at, as a
+    // divisor: 1 is full resolution, 4 a quarter-size proxy (see
+    // GraphExecutor::setProxyScale). Sources shrink what they produce and
+    // filters scale their parameters that are measured in pixels.
+    int jobScale = 1;
+    std::atomic<int> resultScale{1};
+
+    // Set by the editor while one of the node's sliders is being dragged
+    bool interacting = false;
+
+    // Set by the executor when someone is watching (the editor, at full
+    // resolution): slow kernels then render a coarse pass first and refine it
+    // tile by tile, publishing what they have as they go (publishProgress).
+    bool progressive = false;
+    std::atomic<uint64_t> progressVersion{0};  // bumped by every partial result
+
+    // Region of interest. The editor sets viewRegion to the part of the
+    // result a zoomed preview shows, empty while it wants all of it. The
+    // executor works out jobRegion, the part this job computes, back from the
+    // regions its consumers need (see GraphExecutor). resultRegion is the
+    // jobRegion of the current result, empty for a whole result; the executor
+    // plans with it between passes. Readers of the result itself get its
+    // placement from the frame (Frame::area), published along with it.
+    cv::Rect viewRegion;
+    cv::Rect jobRegion;
+    cv::Rect resultRegion;
+
+    // Set by the executor on the last node of a chain it runs tile by tile
+    // (GraphExecutor::setTiled): the nodes before it, first first. Their own
+    // jobs only mark them tiledByConsumer; this node's job runs the chain.
+    std::vector<Node*> tileChain;
+    bool tiledByConsumer = false;
+
+    // Image memory process() allocated beyond what it started with, at its
+    // peak: in the last run, and the most over all runs (see AllocationScope).
+    // Written by the job, read by memory reports on other threads.
+    std::atomic<size_t> lastPeakBytes{0};
+    std::atomic<size_t> highWaterBytes{0};
+
     static std::vector<Node*> availableNodes;
 
     Node(int id, const std::string& name) : id(id), name(name) {}
-    virtual ~Node() = default;
+    virtual ~Node() {
+        for (size_t i = 0; i < inputs.size(); i++) {
+            setInput(static_cast<int>(i), nullptr);
+        }
+        for (Node* output : outputs) {
+            std::replace(output->inputs.begin(), output->inputs.end(), this, static_cast<Node*>(nullptr));
+        }
+    }
 
     virtual void process() = 0;
-    virtual cv::Mat getOutput() const = 0;
-    virtual void drawUI() = 0;
+    virtual Frame getOutput() const = 0;
+    // Empties the result and returns it, for a consumer that takes it over.
+    // Nodes that keep a single ResultSlot override this; the default shares.
+    virtual Frame releaseOutput() { return getOutput(); }
+
+    // What previews show: the partial result of the running job if it has
+    // one, the finished result otherwise. previewVersion() changes with either.
+    Frame previewFrame() const {
+        Frame partial = progress.read();
+        return partial.empty() ? getOutput() : partial;
+    }
+    uint64_t previewVersion() const { return generation + progressVersion; }
+
+    // Tiled execution, see tileChain. A node that computes each pixel from a
+    // window of its single input around the same pixel returns the width of
+    // that window: 1 for pointwise kernels, the kernel size for filters. 0,
+    // the default, means it needs its whole input at once.
+    virtual int footprint() const { return 0; }
+    // Called before the first tile of a job with the size of the image
+    virtual void beginTiles(cv::Size) {}
+    // Returns area of the result from input, which holds inputArea of the
+    // input image: area grown by footprint() / 2 on every side, cut to the
+    // image edges. Runs on several threads at once, and for region jobs.
+    virtual cv::Mat processTile(const ImageView& /*input*/, cv::Rect /*inputArea*/, cv::Rect /*area*/) { return cv::Mat(); }
+    // Keeps the result the tiles were put together into
+    virtual void publishTiles(Frame) {}
+
+    // Every Mat the node keeps as its result, for memory accounting
+    virtual std::vector<Frame> results() const { return {getOutput()}; }
+
+    // Other memory the node holds, for MemoryReport: parameters and lookup
+    // tables that are not results, and the editor's preview textures
+    virtual size_t cacheBytes() const { return 0; }
+    virtual size_t textureBytes() const { return 0; }
+
+    // Frees the results, see MemoryBudget. The next plan that needs them runs
+    // the node again.
+    void evict() {
+        outputReleased = true;
+        releaseResults();
+    }
+    // Headless nodes draw nothing; the editor's *NodeUI subclasses override this
+    virtual void drawUI() {}
+
 
-    
     virtual const std::string& getName() const { return name; }
 
+    // Stable name of the node type, used by graph files and NodeFactory
+    virtual const char* typeName() const = 0;
+
+    // Visits the parameters that are saved with the graph, see ParamVisitor.
+    // paramsLoaded() runs after a visitor has overwritten them.
+    virtual void visitParams(ParamVisitor&) {}
+    virtual void paramsLoaded() { markDirty(); }
+
+    // Hash of the parameter snapshot taken for the current (or last) job.
+    // 0 means the node has no snapshot and always reprocesses.
+    virtual size_t paramsHash() const { return 0; }
+
     virtual void setInput(int index, Node* node) {
-        if (index < inputs.size()) {
-            inputs[index] = node;
-            markDirty();
+        if (index < 0 || index >= static_cast<int>(inputs.size()) || inputs[index] == node) {
+            return;
+        }
+
+        Node* previous = inputs[index];
+        inputs[index] = node;
+
+        // The old producer keeps us as a consumer only if another slot still uses it
+        if (previous && std::find(inputs.begin(), inputs.end(), previous) == inputs.end()) {
+            auto& consumers = previous->outputs;
+            consumers.erase(std::remove(consumers.begin(), consumers.end(), this), consumers.end());
+        }
+        if (node && std::find(node->outputs.begin(), node->outputs.end(), this) == node->outputs.end()) {
+            node->outputs.push_back(this);
         }
+        markDirty();
     }
 
+    // A node that is already dirty has already invalidated everything downstream,
+    // which also stops the walk from looping forever on a cyclic graph
     virtual void markDirty() {
+        if (dirty) return;
         dirty = true;
+        cancelRequested = true;
         for (auto* output : outputs) {
-            if (output) output->markDirty();
+            output->markDirty();
         }
     }
 
+    // True if any input has produced a result since this node last ran
+    bool inputsChanged() const {
+        for (size_t i = 0; i < inputs.size(); i++) {
+            uint64_t seen = i < inputGenerations.size() ? inputGenerations[i] : 0;
+            if (inputs[i] && inputs[i]->generation != seen) return true;
+        }
+        return false;
+    }
+
+    bool needsUpdate() const { return dirty || inputsChanged(); }
+
+    bool cancelled() const { return cancelRequested.load(std::memory_order_relaxed); }
+
+    // Called on the UI thread when the node is scheduled. The dirty flag is
+    // cleared here so that edits made while the job runs schedule another one.
+    void prepare() {
+        dirty = false;
+        cancelRequested = false;
+        recomputing = outputReleased;
+        outputReleased = false;
+        boundInputs = inputs;
+        captureParams();
+    }
+
+    // Runs process() and records what it was computed from. May run on a worker
+    // thread; only touches state that prepare() handed over. If the parameters
+    // and inputs are exactly those of the last result (a control touched without
+    // changing its value, or an upstream node that skipped its own work) the
+    // result is kept and downstream nodes see no new generation. A cancelled job
+    // records nothing; the edit that cancelled it left the node dirty, so the
+    // next pass runs it again with the new value. A released result is rebuilt
+    // from the same parameters and inputs, so consumers are not told about it.
+    void evaluate() {
+        if (cancelled()) return;
+
+        size_t params = paramsHash();
+        size_t key = params;
+        inputGenerations.resize(boundInputs.size());
+        for (size_t i = 0; i < boundInputs.size(); i++) {
+            inputGenerations[i] = boundInputs[i] ? boundInputs[i]->generation.load() : 0;
+            hashCombine(key, boundInputs[i]);
+            hashCombine(key, inputGenerations[i]);
+        }
+        hashCombine(key, jobScale);
+        hashCombine(key, jobRegion.x);
+        hashCombine(key, jobRegion.y);
+        hashCombine(key, jobRegion.width);
+        hashCombine(key, jobRegion.height);
+        bool unchanged = params != 0 && key == lastJobKey;
+        if (unchanged && !recomputing) return;
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            FrameArena::Scope temporaries;
+            AllocationScope allocations;
+            if (tiledByConsumer) {
+                evict();  // computed a tile at a time by its consumer, never whole
+            } else if (!tileChain.empty()) {
+                processTiles();
+            } else if (!jobRegion.empty()) {
+                processRegion();
+            } else {
+                process();
+            }
+            size_t peak = allocations.peakBytes();
+            lastPeakBytes = peak;
+            if (peak > highWaterBytes) highWaterBytes = peak;  // only jobs write it
+        }
+        if (!progress.take().empty()) progressVersion++;
+        if (cancelled()) return;
+        lastRunSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (unchanged) return;
+
+        resultScale = jobScale;
+        resultRegion = jobRegion;
+        lastJobKey = key;
+        generation++;
+    }
+
+protected:
+    // Copies the parameters edited by the UI into the snapshot that process()
+    // reads. Called from prepare() on the UI thread, so a running job never sees
+    // a half-edited value.
+    virtual void captureParams() {}
+
+    // Empties every result slot; see evict()
+    virtual void releaseResults() { releaseOutput(); }
+
+    // For progressive kernels, see progressive: worth it for large images only
+    bool renderProgressively(cv::Size size) const {
+        return progressive && size.area() >= PROGRESSIVE_MIN_PIXELS;
+    }
+
+    // Shows partial, the result being filled in, in previews. Publishes a copy
+    // scaled down to PROGRESS_SIZE across, at most every PROGRESS_INTERVAL
+    // unless force is set, so kernels can call it after every tile.
+    void publishProgress(const cv::Mat& partial, bool force = false) {
+        auto now = std::chrono::steady_clock::now();
+        if (!force && now - lastProgress < PROGRESS_INTERVAL) return;
+        lastProgress = now;
+
+        double scale = std::min(1.0, double(PROGRESS_SIZE) / std::max(partial.cols, partial.rows));
+        cv::Mat preview;
+        cv::resize(partial, preview, cv::Size(), scale, scale, cv::INTER_AREA);
+        progress.publish(Frame(std::move(preview)));
+        progressVersion++;
+    }
+
+    // The result of input index, for process(). If that input donated it, the
+    // frame is handed over and, when no one else holds its pixels, the kernel
+    // may write its own result into them (Frame::takeBuffer) instead of
+    // allocating another image.
+    Frame takeInput(size_t index) {
+        Node* input = boundInputs[index];
+        if (!input) return Frame();
+        if (!input->donatesOutput) return input->getOutput();
+
+        input->outputReleased = true;
+        return input->releaseOutput();
+    }
+
+private:
+    // Runs tileChain and this node over the input of the first one, one
+    // cache-sized tile of the final result at a time (Node.cpp)
+    void processTiles();
+    // Computes jobRegion alone, from the part of the input's result it reads
+    void processRegion();
+
+    static constexpr int PROGRESSIVE_MIN_PIXELS = 1 << 20;
+    static constexpr int PROGRESS_SIZE = 1024;
+    static constexpr std::chrono::milliseconds PROGRESS_INTERVAL{50};
+
+    ResultSlot<Frame> progress;  // partial result of the running job
+    std::chrono::steady_clock::time_point lastProgress;
+
+public:
     static void registerNode(Node* node) {
         availableNodes.push_back(node);
     }
-    
+
     static void clearNodes() {
         availableNodes.clear();
     }
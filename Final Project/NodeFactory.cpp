@@ -0,0 +1,30 @@
+#include "NodeFactory.h"
+#include "LoadImageNode.h"
+#include "BrightnessContrastNode.h"
+#include "ColorChannelSplitNode.h"
+#include "blurnode.h"
+#include "ThresholdNode.h"
+#include "EdgeDetectionNode.h"
+#include "BlendNode.h"
+#include "NoiseGenerationNode.h"
+#include "ConvolutionFilterNode.h"
+#include "OutputNode.h"
+
+NodeFactory::NodeFactory() {
+    add<LoadImageNode>("LoadImageNode");
+    add<BrightnessContrastNode>("BrightnessContrastNode");
+    add<ColorChannelSplitNode>("ColorChannelSplitNode");
+    add<BlurNode>("BlurNode");
+    add<ThresholdNode>("ThresholdNode");
+    add<EdgeDetectionNode>("EdgeDetectionNode");
+    add<BlendNode>("BlendNode");
+    add<NoiseGenerationNode>("NoiseGenerationNode");
+    add<ConvolutionFilterNode>("ConvolutionFilterNode");
+    add<OutputNode>("OutputNode");
+}
+
+std::unique_ptr<Node> NodeFactory::create(const std::string& type, int id) const {
+    auto it = creators.find(type);
+    if (it == creators.end()) return nullptr;
+    return it->second(id);
+}
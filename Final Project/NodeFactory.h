@@ -0,0 +1,29 @@
+#pragma once
+#include "Node.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+// Creates nodes from their typeName(). The default factory knows every core
+// node type; a front end can replace entries with its *NodeUI subclasses so that
+// the nodes it loads can be drawn.
+class NodeFactory {
+public:
+    using Creator = std::function<std::unique_ptr<Node>(int id)>;
+
+    NodeFactory();
+
+    void add(const std::string& type, Creator creator) { creators[type] = std::move(creator); }
+
+    template <typename T>
+    void add(const std::string& type) {
+        add(type, [](int id) { return std::make_unique<T>(id); });
+    }
+
+    // nullptr for an unknown type
+    std::unique_ptr<Node> create(const std::string& type, int id) const;
+
+private:
+    std::map<std::string, Creator> creators;
+};
@@ -1,13 +1,13 @@
 #include "NoiseGenerationNode.h"
-#include <imgui.h>
+#include "TileGrid.h"
 #include <opencv2/imgproc.hpp>
 
 NoiseGenerationNode::NoiseGenerationNode(int id) : Node(id, "Noise Generation") {
     inputs.resize(1);
-    initPermutationTable();
+    initPermutationTable(params.seed);
 }
 
-void NoiseGenerationNode::initPermutationTable() {
+void NoiseGenerationNode::initPermutationTable(int seed) {
     p.resize(512);
     std::iota(p.begin(), p.begin() + 256, 0);
     
@@ -15,66 +15,126 @@ void NoiseGenerationNode::initPermutationTable() {
     std::shuffle(p.begin(), p.begin() + 256, rng);
     
     std::copy_n(p.begin(), 256, p.begin() + 256);
+    permutationSeed = seed;
 }
 
 void NoiseGenerationNode::process() {
-    if (inputs[0]) {
-        cv::Mat input = inputs[0]->getOutput();
-        if (!input.empty()) {
-            // Update dimensions to match input image
-            width = input.cols;
-            height = input.rows;
-
-            // Generate noise map
-            cv::Mat noiseMap;
-            switch (noiseType) {
-                case 0:
-                    noiseMap = generatePerlinNoise();
-                    break;
-                case 1:
-                    noiseMap = generateSimplexNoise();
-                    break;
-                case 2:
-                    noiseMap = generateWorleyNoise();
-                    break;
-            }
-
-            if (useAsDisplacement) {
-                // Use noise as displacement map
-                output = applyDisplacementMap(input, noiseMap);
-            } else {
-                // Use noise as direct color addition
-                cv::Mat processedNoise;
-                if (input.channels() == 3) {
-                    cv::cvtColor(noiseMap, processedNoise, cv::COLOR_GRAY2BGR);
-                } else {
-                    processedNoise = noiseMap;
+    if (boundInputs[0]) {
+        Frame inputFrame = takeInput(0);
+        if (!inputFrame.empty()) {
+            // The same per-job setup as a tiled job
+            beginTiles(inputFrame.size());
+
+            // Displacement reads the input around each pixel, and the
+            // progressive passes read it twice, so only a single pass adding
+            // noise may write over it
+            bool progressive = renderProgressively(inputFrame.size());
+            cv::Mat result = jobParams.useAsDisplacement || progressive ? cv::Mat() : inputFrame.takeBuffer();
+            ImageView input = result.empty() ? inputFrame.view() : ImageView(result);
+            result.create(input.size(), input.type());
+            cv::Mat noiseMap(height, width, CV_8UC1);
+            cv::Rect whole(0, 0, width, height);
+
+            if (progressive) {
+                // A coarse pass sampling every COARSE_STEP-th pixel, scaled
+                // up, then the exact noise a tile at a time, centre first
+                cv::Mat coarse((height + COARSE_STEP - 1) / COARSE_STEP, (width + COARSE_STEP - 1) / COARSE_STEP, CV_8UC1);
+                renderNoise(coarse, cv::Rect(0, 0, coarse.cols, coarse.rows), COARSE_STEP);
+                cv::resize(coarse, noiseMap, noiseMap.size(), 0, 0, cv::INTER_LINEAR);
+                composite(input, whole, noiseMap, result, whole);
+                publishProgress(result, true);
+
+                for (const cv::Rect& tile : TileGrid::centreFirst(input.size())) {
+                    if (cancelled()) return;
+                    cv::Mat tileNoise = noiseMap(tile);
+                    cv::Mat tileResult = result(tile);
+                    renderNoise(tileNoise, tile, 1);
+                    composite(input, whole, tileNoise, tileResult, tile);
+                    publishProgress(result);
                 }
-                processedNoise.convertTo(processedNoise, input.type());
-                
-                // Add noise to input image
-                output = input.clone();
-                cv::addWeighted(input, 1.0, processedNoise, noiseStrength, 0.0, output);
-            }
-
-            // Update texture
-            if (texture) {
-                glDeleteTextures(1, &texture);
+            } else {
+                renderNoise(noiseMap, whole, 1);
+                if (cancelled()) return;
+                composite(input, whole, noiseMap, result, whole);
             }
-            texture = matToTexture(output);
+            if (cancelled()) return;
+            output.publish(Frame(std::move(result), jobScale));
         }
     }
-    dirty = false;
 }
 
-cv::Mat NoiseGenerationNode::applyDisplacementMap(const cv::Mat& input, const cv::Mat& noiseMap) {
-    cv::Mat output = input.clone();
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
+void NoiseGenerationNode::beginTiles(cv::Size size) {
+    // Update dimensions to match input image
+    width = size.width;
+    height = size.height;
+
+    // Scale and displacement are in full resolution pixels; on a proxy
+    // they shrink with the image so the pattern looks the same
+    featureScale = jobParams.scale / jobScale;
+    displacementStrength = jobParams.displacementStrength / jobScale;
+
+    if (jobParams.seed != permutationSeed) {
+        initPermutationTable(jobParams.seed);
+    }
+
+    points.clear();
+    if (jobParams.noiseType == 2) {
+        placeWorleyPoints(points);
+    }
+}
+
+cv::Mat NoiseGenerationNode::processTile(const ImageView& input, cv::Rect inputArea, cv::Rect area) {
+    cv::Mat noiseMap(area.size(), CV_8UC1);
+    renderNoise(noiseMap, area, 1);
+    cv::Mat result(area.size(), input.type());
+    composite(input, inputArea, noiseMap, result, area);
+    return result;
+}
+
+void NoiseGenerationNode::renderNoise(cv::Mat& noiseMap, cv::Rect area, int step) {
+    switch (jobParams.noiseType) {
+        case 0:
+            generatePerlinNoise(noiseMap, area, step);
+            break;
+        case 1:
+            generateSimplexNoise(noiseMap, area, step);
+            break;
+        case 2:
+            generateWorleyNoise(noiseMap, area, step);
+            break;
+    }
+}
+
+void NoiseGenerationNode::composite(const ImageView& input, cv::Rect inputArea, const cv::Mat& noiseMap,
+                                    cv::Mat& result, cv::Rect area) {
+    if (jobParams.useAsDisplacement) {
+        // Use noise as displacement map
+        applyDisplacementMap(input, inputArea, noiseMap, result, area);
+        return;
+    }
+
+    // Use noise as direct color addition
+    cv::Mat processedNoise;
+    if (input.channels() == 3) {
+        cv::cvtColor(noiseMap, processedNoise, cv::COLOR_GRAY2BGR);
+    } else {
+        processedNoise = noiseMap;
+    }
+    processedNoise.convertTo(processedNoise, input.type());
+
+    // Add noise to input image
+    cv::addWeighted(input(area - inputArea.tl()), 1.0, processedNoise, jobParams.noiseStrength, 0.0, result);
+}
+
+void NoiseGenerationNode::applyDisplacementMap(const ImageView& input, cv::Rect inputArea, const cv::Mat& noiseMap,
+                                               cv::Mat& output, cv::Rect area) {
+    for (int y = area.y; y < area.br().y; y++) {
+        if (cancelled()) break;  // superseded by a newer edit
+        for (int x = area.x; x < area.br().x; x++) {
             // Get displacement from noise
-            float dx = (noiseMap.at<uchar>(y, x) / 255.0f - 0.5f) * displacementStrength;
-            float dy = (noiseMap.at<uchar>(y, x) / 255.0f - 0.5f) * displacementStrength;
+            uchar noise = noiseMap.at<uchar>(y - area.y, x - area.x);
+            float dx = (noise / 255.0f - 0.5f) * displacementStrength;
+            float dy = (noise / 255.0f - 0.5f) * displacementStrength;
             
             // Calculate source pixel coordinates
             int sx = cv::borderInterpolate(x + static_cast<int>(dx), width, cv::BORDER_REFLECT_101);
@@ -82,43 +142,37 @@ cv::Mat NoiseGenerationNode::applyDisplacementMap(const cv::Mat& input, const cv
             
             // Copy pixel
             if (input.channels() == 3) {
-                output.at<cv::Vec3b>(y, x) = input.at<cv::Vec3b>(sy, sx);
+                output.at<cv::Vec3b>(y - area.y, x - area.x) = input.at<cv::Vec3b>(sy - inputArea.y, sx - inputArea.x);
             } else {
-                output.at<uchar>(y, x) = input.at<uchar>(sy, sx);
+                output.at<uchar>(y - area.y, x - area.x) = input.at<uchar>(sy - inputArea.y, sx - inputArea.x);
             }
         }
     }
-    
-    return output;
 }
 
-cv::Mat NoiseGenerationNode::generatePerlinNoise() {
-    cv::Mat noiseMap(height, width, CV_8UC1);
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            float nx = x / scale;
-            float ny = y / scale;
+void NoiseGenerationNode::generatePerlinNoise(cv::Mat& noiseMap, cv::Rect area, int step) {
+    for (int y = area.y; y < area.br().y; y++) {
+        if (cancelled()) break;
+        for (int x = area.x; x < area.br().x; x++) {
+            float nx = x * step / featureScale;
+            float ny = y * step / featureScale;
             
             float value = octaveNoise(nx, ny);
             value = (value + 1.0f) * 0.5f;
-            noiseMap.at<uchar>(y, x) = static_cast<uchar>(value * 255);
+            noiseMap.at<uchar>(y - area.y, x - area.x) = static_cast<uchar>(value * 255);
         }
     }
-    
-    return noiseMap;
 }
 
-cv::Mat NoiseGenerationNode::generateSimplexNoise() {
-    cv::Mat noiseMap(height, width, CV_8UC1);
-    
+void NoiseGenerationNode::generateSimplexNoise(cv::Mat& noiseMap, cv::Rect area, int step) {
     const float F2 = 0.5f * (sqrt(3.0f) - 1.0f);
     const float G2 = (3.0f - sqrt(3.0f)) / 6.0f;
     
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            float nx = x / scale;
-            float ny = y / scale;
+    for (int y = area.y; y < area.br().y; y++) {
+        if (cancelled()) break;
+        for (int x = area.x; x < area.br().x; x++) {
+            float nx = x * step / featureScale;
+            float ny = y * step / featureScale;
             
             float s = (nx + ny) * F2;
             int i = floor(nx + s);
@@ -150,18 +204,13 @@ cv::Mat NoiseGenerationNode::generateSimplexNoise() {
             
             float value = 70.0f * (n0 + n1 + n2);
             value = (value + 1.0f) * 0.5f;
-            noiseMap.at<uchar>(y, x) = cv::saturate_cast<uchar>(value * 255);
+            noiseMap.at<uchar>(y - area.y, x - area.x) = cv::saturate_cast<uchar>(value * 255);
         }
     }
-    
-    return noiseMap;
 }
 
-cv::Mat NoiseGenerationNode::generateWorleyNoise() {
-    cv::Mat noiseMap(height, width, CV_8UC1);
-    std::vector<cv::Point2f> points;
-    
-    std::mt19937 rng(seed);
+void NoiseGenerationNode::placeWorleyPoints(std::vector<cv::Point2f>& points) {
+    std::mt19937 rng(jobParams.seed);
     std::uniform_real_distribution<float> dist(0.0f, 1.0f);
     
     int numPoints = 20;
@@ -171,15 +220,18 @@ cv::Mat NoiseGenerationNode::generateWorleyNoise() {
             dist(rng) * height
         ));
     }
-    
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
+}
+
+void NoiseGenerationNode::generateWorleyNoise(cv::Mat& noiseMap, cv::Rect area, int step) {
+    for (int y = area.y; y < area.br().y; y++) {
+        if (cancelled()) break;
+        for (int x = area.x; x < area.br().x; x++) {
             float minDist = FLT_MAX;
             float secondMinDist = FLT_MAX;
             
             for (const auto& point : points) {
-                float dx = x - point.x;
-                float dy = y - point.y;
+                float dx = x * step - point.x;
+                float dy = y * step - point.y;
                 float dist = sqrt(dx * dx + dy * dy);
                 
                 if (dist < minDist) {
@@ -190,12 +242,10 @@ cv::Mat NoiseGenerationNode::generateWorleyNoise() {
                 }
             }
             
-            float value = (secondMinDist - minDist) / scale;
-            noiseMap.at<uchar>(y, x) = cv::saturate_cast<uchar>(value * 255);
+            float value = (secondMinDist - minDist) / featureScale;
+            noiseMap.at<uchar>(y - area.y, x - area.x) = cv::saturate_cast<uchar>(value * 255);
         }
     }
-    
-    return noiseMap;
 }
 
 float NoiseGenerationNode::simplexCornerNoise(float x, float y, int i, int j) {
@@ -257,125 +307,16 @@ float NoiseGenerationNode::octaveNoise(float x, float y) {
     float amplitude = 1;
     float maxValue = 0;
     
-    for (int i = 0; i < octaves; i++) {
+    for (int i = 0; i < jobParams.octaves; i++) {
         total += noise2D(x * frequency, y * frequency) * amplitude;
         maxValue += amplitude;
-        amplitude *= persistence;
-        frequency *= lacunarity;
+        amplitude *= jobParams.persistence;
+        frequency *= jobParams.lacunarity;
     }
     
     return total / maxValue;
 }
 
-void NoiseGenerationNode::drawUI() {
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
-    ImVec2 p0 = ImGui::GetCursorScreenPos();
-    ImVec2 size = ImGui::GetContentRegionAvail();
-    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);
-
-    // Gradient background
-    ImVec4 color1 = ImVec4(84.0f / 255.0f, 90.0f / 255.0f, 0.0f / 255.0f, 1.0f);
-    ImVec4 color2 = ImVec4(0.0f / 255.0f, 0.0f / 255.0f, 0.0f / 255.0f, 1.0f);
-
-    draw_list->AddRectFilledMultiColor(p0, p1,
-        ImColor(color1), ImColor(color1),
-        ImColor(color2), ImColor(color2));
-
-    // UI on top
-    ImGui::SetCursorScreenPos(p0);
-    
-    // Input selection
-    ImGui::Text("Input Image:");
-    if (ImGui::BeginCombo("Input##Noise", 
-        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
-        
-        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
-            setInput(0, nullptr);
-            markDirty();
-        }
-        
-        for (Node* node : Node::availableNodes) {
-            if (node != this) {
-                bool is_selected = (inputs[0] == node);
-                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
-                    setInput(0, node);
-                    markDirty();
-                }
-            }
-        }
-        ImGui::EndCombo();
-    }
-
-    // Noise parameters
-    const char* noiseTypes[] = { "Perlin", "Simplex", "Worley" };
-    if (ImGui::Combo("Noise Type", &noiseType, noiseTypes, IM_ARRAYSIZE(noiseTypes))) {
-        markDirty();
-    }
-
-    if (ImGui::Checkbox("Use as Displacement Map", &useAsDisplacement)) {
-        markDirty();
-    }
-
-    if (useAsDisplacement) {
-        if (ImGui::SliderFloat("Displacement Strength", &displacementStrength, 0.0f, 50.0f)) {
-            markDirty();
-        }
-    } else {
-        if (ImGui::SliderFloat("Noise Strength", &noiseStrength, 0.0f, 1.0f)) {
-            markDirty();
-        }
-    }
-
-    if (ImGui::SliderFloat("Scale", &scale, 1.0f, 100.0f)) {
-        markDirty();
-    }
-
-    if (ImGui::SliderInt("Octaves", &octaves, 1, 8)) {
-        markDirty();
-    }
-
-    if (ImGui::SliderFloat("Persistence", &persistence, 0.0f, 1.0f)) {
-        markDirty();
-    }
-
-    if (ImGui::SliderFloat("Lacunarity", &lacunarity, 1.0f, 4.0f)) {
-        markDirty();
-    }
-
-    if (ImGui::InputInt("Seed", &seed)) {
-        initPermutationTable();
-        markDirty();
-    }
-
-    // Result preview
-    if (texture) {
-        ImGui::Text("Result:");
-        ImGui::Image((ImTextureID)(intptr_t)texture, ImVec2(300, 300));
-    }
-}
-
-cv::Mat NoiseGenerationNode::getOutput() const {
-    return output;
-}
-
-GLuint NoiseGenerationNode::matToTexture(const cv::Mat& mat) {
-    cv::Mat rgbMat;
-    GLenum format;
-
-    if (mat.channels() == 3) {
-        cv::cvtColor(mat, rgbMat, cv::COLOR_BGR2RGB);
-        format = GL_RGB;
-    } else {
-        cv::cvtColor(mat, rgbMat, cv::COLOR_GRAY2RGB);
-        format = GL_RGB;
-    }
-
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, rgbMat.cols, rgbMat.rows, 0, format, GL_UNSIGNED_BYTE, rgbMat.data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    return textureID;
-}
+Frame NoiseGenerationNode::getOutput() const {
+    return output.read();
+}
\ No newline at end of file
@@ -1,51 +1,101 @@
 #pragma once
 #include "Node.h"
-#include <GL/glew.h>
+#include "ResultSlot.h"
 #include <random>
 #include <numeric>
 
 class NoiseGenerationNode : public Node {
 public:
+    // Noise parameters
+    struct Params {
+        int noiseType = 0;  // 0: Perlin, 1: Simplex, 2: Worley
+        float scale = 50.0f;
+        int octaves = 4;
+        float persistence = 0.5f;
+        float lacunarity = 2.0f;
+        int seed = 1234;
+        float noiseStrength = 0.5f;
+
+        // Displacement parameters
+        bool useAsDisplacement = false;  // false for direct color output, true for displacement
+        float displacementStrength = 10.0f;  // Strength of displacement effect
+
+        auto tie() const {
+            return std::tie(noiseType, scale, octaves, persistence, lacunarity, seed,
+                            noiseStrength, useAsDisplacement, displacementStrength);
+        }
+        bool operator==(const Params& other) const { return tie() == other.tie(); }
+        size_t hash() const { return hashTuple(tie()); }
+        void visit(ParamVisitor& v) {
+            v.field("noiseType", noiseType);
+            v.field("scale", scale);
+            v.field("octaves", octaves);
+            v.field("persistence", persistence);
+            v.field("lacunarity", lacunarity);
+            v.field("seed", seed);
+            v.field("noiseStrength", noiseStrength);
+            v.field("useAsDisplacement", useAsDisplacement);
+            v.field("displacementStrength", displacementStrength);
+        }
+    };
+
     NoiseGenerationNode(int id);
     void process() override;
-    cv::Mat getOutput() const override;
-    void drawUI() override;
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return output.take(); }
+    size_t paramsHash() const override { return jobParams.hash(); }
+    const char* typeName() const override { return "NoiseGenerationNode"; }
+    void visitParams(ParamVisitor& v) override { params.visit(v); }
+
+    // Adding noise is pointwise; displacement reads up to half its strength away
+    int footprint() const override {
+        if (!jobParams.useAsDisplacement) return 1;
+        return 2 * static_cast<int>(std::ceil(jobParams.displacementStrength / jobScale / 2)) + 1;
+    }
+    void beginTiles(cv::Size size) override;
+    cv::Mat processTile(const ImageView& input, cv::Rect inputArea, cv::Rect area) override;
+    void publishTiles(Frame result) override { output.publish(std::move(result)); }
+
+    Params params;  // edited by the UI
+
+protected:
+    ResultSlot<Frame> output;
 
 private:
-    cv::Mat output;
-    GLuint texture = 0;
-    
-    // Noise parameters
-    int noiseType = 0;  // 0: Perlin, 1: Simplex, 2: Worley
+    Params jobParams;  // snapshot read by process()
     int width = 512;    // Default width
     int height = 512;   // Default height
-    float scale = 50.0f;
-    int octaves = 4;
-    float persistence = 0.5f;
-    float lacunarity = 2.0f;
-    int seed = 1234;
-    float noiseStrength = 0.5f;
-    
-    // Displacement parameters
-    bool useAsDisplacement = false;  // false for direct color output, true for displacement
-    float displacementStrength = 10.0f;  // Strength of displacement effect
-    
-    // Noise generation methods
-    cv::Mat generatePerlinNoise();
-    cv::Mat generateSimplexNoise();
-    cv::Mat generateWorleyNoise();
+    float featureScale = 50.0f;          // jobParams.scale at the job's resolution
+    float displacementStrength = 10.0f;  // likewise for jobParams.displacementStrength
+    std::vector<cv::Point2f> points;  // Worley feature points of the job; cleared, not freed, between jobs
+
+    // Coarse progressive pass: one sample every COARSE_STEP pixels
+    static constexpr int COARSE_STEP = 8;
+
+    // Noise generation methods. Each fills noiseMap with area of a map whose
+    // pixel (x, y) is the noise at (x * step, y * step) of the full image.
+    void renderNoise(cv::Mat& noiseMap, cv::Rect area, int step);
+    void generatePerlinNoise(cv::Mat& noiseMap, cv::Rect area, int step);
+    void generateSimplexNoise(cv::Mat& noiseMap, cv::Rect area, int step);
+    void placeWorleyPoints(std::vector<cv::Point2f>& points);
+    void generateWorleyNoise(cv::Mat& noiseMap, cv::Rect area, int step);
     float simplexCornerNoise(float x, float y, int i, int j);
     
     // Helper methods
-    GLuint matToTexture(const cv::Mat& mat);
+    void captureParams() override { jobParams = params; }
     float fade(float t);
     float lerp(float a, float b, float t);
     float grad(int hash, float x, float y);
     float noise2D(float x, float y);
     float octaveNoise(float x, float y);
-    cv::Mat applyDisplacementMap(const cv::Mat& input, const cv::Mat& noiseMap);
+    // Fill result with area of the result, from input, which holds inputArea
+    // of the input image, and noiseMap, which holds area of the noise
+    void composite(const ImageView& input, cv::Rect inputArea, const cv::Mat& noiseMap, cv::Mat& result, cv::Rect area);
+    void applyDisplacementMap(const ImageView& input, cv::Rect inputArea, const cv::Mat& noiseMap, cv::Mat& output,
+                              cv::Rect area);
     
     // Permutation table for Perlin noise
     std::vector<int> p;
-    void initPermutationTable();
+    int permutationSeed = 0;  // seed p was shuffled with
+    void initPermutationTable(int seed);
 };
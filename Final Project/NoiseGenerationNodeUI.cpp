@@ -0,0 +1,94 @@
+#include "NoiseGenerationNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+
+void NoiseGenerationNodeUI::drawUI() {
+    // Raised again below while any slider is being dragged, see GraphExecutor::setProxyScale
+    interacting = false;
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();
+    ImVec2 size = ImGui::GetContentRegionAvail();
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);
+
+    // Gradient background
+    ImVec4 color1 = ImVec4(84.0f / 255.0f, 90.0f / 255.0f, 0.0f / 255.0f, 1.0f);
+    ImVec4 color2 = ImVec4(0.0f / 255.0f, 0.0f / 255.0f, 0.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),
+        ImColor(color2), ImColor(color2));
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0);
+    
+    // Input selection
+    ImGui::Text("Input Image:");
+    if (ImGui::BeginCombo("Input##Noise", 
+        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
+        
+        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
+            setInput(0, nullptr);
+            markDirty();
+        }
+        
+        for (Node* node : Node::availableNodes) {
+            if (node != this) {
+                bool is_selected = (inputs[0] == node);
+                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
+                    setInput(0, node);
+                    markDirty();
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    // Noise parameters
+    const char* noiseTypes[] = { "Perlin", "Simplex", "Worley" };
+    if (ImGui::Combo("Noise Type", &params.noiseType, noiseTypes, IM_ARRAYSIZE(noiseTypes))) {
+        markDirty();
+    }
+
+    if (ImGui::Checkbox("Use as Displacement Map", &params.useAsDisplacement)) {
+        markDirty();
+    }
+
+    if (params.useAsDisplacement) {
+        if (ImGui::SliderFloat("Displacement Strength", &params.displacementStrength, 0.0f, 50.0f)) {
+            markDirty();
+        }
+        interacting |= ImGui::IsItemActive();
+    } else {
+        if (ImGui::SliderFloat("Noise Strength", &params.noiseStrength, 0.0f, 1.0f)) {
+            markDirty();
+        }
+        interacting |= ImGui::IsItemActive();
+    }
+
+    if (ImGui::SliderFloat("Scale", &params.scale, 1.0f, 100.0f)) {
+        markDirty();
+    }
+    interacting |= ImGui::IsItemActive();
+
+    if (ImGui::SliderInt("Octaves", &params.octaves, 1, 8)) {
+        markDirty();
+    }
+    interacting |= ImGui::IsItemActive();
+
+    if (ImGui::SliderFloat("Persistence", &params.persistence, 0.0f, 1.0f)) {
+        markDirty();
+    }
+    interacting |= ImGui::IsItemActive();
+
+    if (ImGui::SliderFloat("Lacunarity", &params.lacunarity, 1.0f, 4.0f)) {
+        markDirty();
+    }
+    interacting |= ImGui::IsItemActive();
+
+    if (ImGui::InputInt("Seed", &params.seed)) {
+        markDirty();
+    }
+
+    // Result preview, or the noise so far while it renders
+    resultPreview.drawResult("Result:", *this);
+}
\ No newline at end of file
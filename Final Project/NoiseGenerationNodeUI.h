@@ -0,0 +1,16 @@
+#pragma once
+#include "NoiseGenerationNode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for NoiseGenerationNode: ImGui controls and preview texture
+class NoiseGenerationNodeUI : public NoiseGenerationNode {
+public:
+    using NoiseGenerationNode::NoiseGenerationNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage resultPreview{this, 0, ImVec2(300, 300)};
+};
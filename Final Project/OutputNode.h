@@ -1,27 +1,33 @@
 #pragma once
 #include "Node.h"
-#include <GL/glew.h>
+#include "ResultSlot.h"
 
 class OutputNode : public Node {
 public:
     OutputNode(int id);
     void process() override;
-    cv::Mat getOutput() const override;
-    void drawUI() override;
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return output.take(); }
+    const char* typeName() const override { return "OutputNode"; }
+    void visitParams(ParamVisitor& v) override;
 
+    // Passes its input through, so it can show a region of it
+    int footprint() const override { return 1; }
+    cv::Mat processTile(const ImageView& input, cv::Rect inputArea, cv::Rect area) override {
+        return input(area - inputArea.tl()).clone();
+    }
+    void publishTiles(Frame result) override { output.publish(std::move(result)); }
 
-private:
-    cv::Mat output;
-    GLuint texture = 0;
+    // Writes the current result with the selected format and quality
+    bool saveImage(const std::string& path);
+    const char* fileExtension() const;  // ".jpg", ".png" or ".bmp" for the format
+
+protected:
+    ResultSlot<Frame> output;
     
     // Output parameters
     std::string savePath;
     int format = 0;  // 0: JPG, 1: PNG, 2: BMP
     int jpgQuality = 95;  // 0-100 for JPG
     int pngCompression = 6;  // 0-9 for PNG
-    
-    // Methods
-    GLuint matToTexture(const cv::Mat& mat);
-    bool saveImage();
-    void showSaveFileDialog();
 };
\ No newline at end of file
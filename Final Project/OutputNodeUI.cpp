@@ -0,0 +1,92 @@
+#include "OutputNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+#include "tinyfiledialogs.h"
+
+void OutputNodeUI::showSaveFileDialog() {
+    const char* filters[3] = { "*.jpg", "*.png", "*.bmp" };
+    const char* selected = tinyfd_saveFileDialog(
+        "Save Image",
+        "",
+        3,
+        filters,
+        format == 0 ? "JPEG Files" : 
+        format == 1 ? "PNG Files" : "BMP Files"
+    );
+
+    if (selected) {
+        saveImage(selected);
+    }
+}
+
+void OutputNodeUI::drawUI() {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
+    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom right
+
+    // Gradient colors
+    ImVec4 color1 = ImVec4(54.0f / 255.0f, 69.0f / 255.0f, 79.0f / 255.0f, 1.0f);
+    ImVec4 color2 = ImVec4(25.0f / 255.0f, 25.0f / 255.0f, 112.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),  // top left to top right
+        ImColor(color2), ImColor(color2)); // bottom left to bottom right
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0); 
+    // Input selection
+    ImGui::Text("Input Image:");
+    if (ImGui::BeginCombo("Input##Output", 
+        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
+        
+        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
+            setInput(0, nullptr);
+            markDirty();
+        }
+        
+        for (Node* node : Node::availableNodes) {
+            if (node != this) {
+                bool is_selected = (inputs[0] == node);
+                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
+                    setInput(0, node);
+                    markDirty();
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    // Format selection
+    const char* formats[] = { "JPEG", "PNG", "BMP" };
+    if (ImGui::Combo("Format", &format, formats, IM_ARRAYSIZE(formats))) {
+        markDirty();
+    }
+
+    // Quality settings based on format
+    switch (format) {
+        case 0: // JPG
+            if (ImGui::SliderInt("JPEG Quality", &jpgQuality, 0, 100)) {
+                markDirty();
+            }
+            break;
+        case 1: // PNG
+            if (ImGui::SliderInt("PNG Compression", &pngCompression, 0, 9)) {
+                markDirty();
+            }
+            break;
+    }
+
+    // Save button
+    if (ImGui::Button("Save Image")) {
+        showSaveFileDialog();
+    }
+
+    // Show save path if exists
+    if (!savePath.empty()) {
+        ImGui::Text("Last Save: %s", savePath.c_str());
+    }
+
+    // Preview
+    resultPreview.drawResult("Preview:", *this);
+}
\ No newline at end of file
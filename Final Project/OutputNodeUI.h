@@ -0,0 +1,18 @@
+#pragma once
+#include "OutputNode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for OutputNode: format controls, save dialog and preview
+class OutputNodeUI : public OutputNode {
+public:
+    using OutputNode::OutputNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage resultPreview{this, 0, ImVec2(300, 300)};
+
+    void showSaveFileDialog();
+};
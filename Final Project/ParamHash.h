@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Helpers for the per-node Params structs: each struct exposes its fields as a
+// tuple through tie(), which gives equality and a hash usable as a cache key.
+
+template <typename T>
+void hashCombine(size_t& seed, const T& value) {
+    seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+template <typename T>
+void hashCombine(size_t& seed, const std::vector<T>& values) {
+    hashCombine(seed, values.size());
+    for (const T& value : values) {
+        hashCombine(seed, value);
+    }
+}
+
+template <typename Tuple>
+size_t hashTuple(const Tuple& fields) {
+    size_t seed = 0;
+    std::apply([&seed](const auto&... field) { (hashCombine(seed, field), ...); }, fields);
+    return seed;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Walks the saved parameters of a node by name. The same visit code serves
+// saving (the visitor reads each field) and loading (it overwrites them), so
+// every node lists its fields in exactly one place.
+class ParamVisitor {
+public:
+    virtual ~ParamVisitor() = default;
+
+    virtual void field(const char* name, int& value) = 0;
+    virtual void field(const char* name, float& value) = 0;
+    virtual void field(const char* name, double& value) = 0;
+    virtual void field(const char* name, bool& value) = 0;
+    virtual void field(const char* name, std::string& value) = 0;
+    virtual void field(const char* name, std::vector<float>& value) = 0;
+};
@@ -0,0 +1,119 @@
+#include "PooledMatAllocator.h"
+#include "AllocationScope.h"
+
+PooledMatAllocator::PooledMatAllocator(size_t capacity) : capacity(capacity) {}
+
+PooledMatAllocator::~PooledMatAllocator() {
+    trim();
+}
+
+PooledMatAllocator& PooledMatAllocator::instance() {
+    static PooledMatAllocator* pool = new PooledMatAllocator();
+    return *pool;
+}
+
+void PooledMatAllocator::install() {
+    cv::Mat::setDefaultAllocator(&instance());
+}
+
+size_t PooledMatAllocator::bucketSize(size_t bytes) {
+    size_t power = 1;
+    while (power <= bytes / 2) power *= 2;
+    size_t step = std::max<size_t>(power / 4, 1);
+    return (bytes + step - 1) / step * step;
+}
+
+cv::UMatData* PooledMatAllocator::allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const {
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = 0; i < dims; i++) {
+        total *= sizes[i];
+    }
+
+    cv::MatAllocator* standard = cv::Mat::getStdAllocator();
+    if (data || total < MIN_POOLED_SIZE) {
+        return standard->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    // Continuous layout, as the standard allocator produces for new Mats
+    if (step) {
+        size_t rowStep = CV_ELEM_SIZE(type);
+        for (int i = dims - 1; i >= 0; i--) {
+            step[i] = rowStep;
+            rowStep *= sizes[i];
+        }
+    }
+
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = static_cast<uchar*>(take(bucketSize(total)));
+    u->size = total;
+    AllocationScope::allocated(total);
+    return u;
+}
+
+bool PooledMatAllocator::allocate(cv::UMatData* data, cv::AccessFlag, cv::UMatUsageFlags) const {
+    return data != nullptr;
+}
+
+void PooledMatAllocator::deallocate(cv::UMatData* u) const {
+    if (!u) return;
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+
+    AllocationScope::released(u->size);
+    give(u->origdata, bucketSize(u->size));
+    u->origdata = nullptr;
+    delete u;
+}
+
+void* PooledMatAllocator::take(size_t bucket) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = freeBuffers.find(bucket);
+        if (it != freeBuffers.end() && !it->second.empty()) {
+            void* buffer = it->second.back();
+            it->second.pop_back();
+            counters.pooledBytes -= bucket;
+            counters.hits++;
+            return buffer;
+        }
+        counters.misses++;
+    }
+    return cv::fastMalloc(bucket);
+}
+
+void PooledMatAllocator::give(void* buffer, size_t bucket) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (counters.pooledBytes + bucket <= capacity) {
+            freeBuffers[bucket].push_back(buffer);
+            counters.pooledBytes += bucket;
+            return;
+        }
+    }
+    cv::fastFree(buffer);
+}
+
+PooledMatAllocator::Stats PooledMatAllocator::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void PooledMatAllocator::setCapacity(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = bytes;
+}
+
+void PooledMatAllocator::trim() {
+    std::map<size_t, std::vector<void*>> released;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        released.swap(freeBuffers);
+        counters.pooledBytes = 0;
+    }
+    for (auto& bucket : released) {
+        for (void* buffer : bucket.second) {
+            cv::fastFree(buffer);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// cv::MatAllocator that recycles large pixel buffers instead of returning them
+// to the heap. Every slider move reallocates full-size Mats in process(),
+// matToTexture() and inside OpenCV itself; with the pool installed as the
+// default allocator those buffers come back from a free list keyed by size.
+//
+// Sizes are rounded up to one of four steps per power of two, so a recycled
+// buffer wastes at most a quarter of its size and images of nearly equal size
+// share a bucket. Small Mats, and Mats wrapping user memory, go straight to
+// OpenCV's standard allocator.
+class PooledMatAllocator : public cv::MatAllocator {
+public:
+    struct Stats {
+        size_t hits = 0;          // allocations served from the pool
+        size_t misses = 0;        // allocations that went to the heap
+        size_t pooledBytes = 0;   // free buffers currently held
+
+        double hitRate() const { return hits + misses ? double(hits) / double(hits + misses) : 0.0; }
+    };
+
+    static const size_t MIN_POOLED_SIZE = 64 * 1024;
+
+    explicit PooledMatAllocator(size_t capacity = size_t(1) << 30);
+    ~PooledMatAllocator() override;
+
+    // The process-wide pool, installed with cv::Mat::setDefaultAllocator().
+    // Never destroyed, so Mats released during static destruction stay valid.
+    static PooledMatAllocator& instance();
+    static void install();
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+    Stats stats() const;
+    void setCapacity(size_t bytes);   // most free bytes kept; beyond it buffers are freed
+    void trim();                      // frees every pooled buffer
+
+    static size_t bucketSize(size_t bytes);
+
+private:
+    mutable std::mutex mutex;
+    mutable std::map<size_t, std::vector<void*>> freeBuffers;  // by bucket size
+    mutable Stats counters;
+    size_t capacity;
+
+    void* take(size_t bucket) const;
+    void give(void* buffer, size_t bucket) const;
+};
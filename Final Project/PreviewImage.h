@@ -0,0 +1,125 @@
+#pragma once
+#include "Node.h"
+#include "TextureCache.h"
+#include "TileGrid.h"
+#include <GL/glew.h>
+#include <imgui.h>
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+
+// One preview of a node window. Its texture is uploaded at draw time, and only
+// while the preview is on screen: the editor skips drawUI() for windows whose
+// Begin() returned false (collapsed or clipped away), and draw() skips the
+// upload of a preview scrolled out of view. A hidden preview costs nothing;
+// it catches up the first frame it is visible again.
+//
+// Previews upload a thumbnail of the size they are drawn at (see
+// TextureCache::update). Clicking one toggles zoom: the full resolution is
+// uploaded instead and a window of its own shows it pixel for pixel. A zoomed
+// result preview asks its node for the region in view only (Node::viewRegion),
+// with a margin so that scrolling a little does not ask again.
+class PreviewImage {
+public:
+    PreviewImage(const void* owner, int index, ImVec2 size, bool zoomable = true)
+        : owner(owner), index(index), size(size), zoomable(zoomable) {}
+
+    // Draws label and the image under it at the cursor, or nothing while there
+    // is nothing to show. version identifies the image (the node's generation,
+    // say); read() returns it and is only called when version differs from
+    // the uploaded one and the preview is visible.
+    template <typename Read>
+    void draw(const char* label, const std::string& title, uint64_t version, Read read) {
+        TextureCache& cache = TextureCache::shared();
+        GLuint texture = cache.texture(owner, index);
+        bool stale = reload || version != shownVersion;
+        if (!texture && !stale) return;
+
+        ImGui::Text("%s", label);
+        if (stale && ImGui::IsRectVisible(size)) {
+            cv::Size fit = zoomed ? cv::Size() : cv::Size(int(size.x), int(size.y));
+            shownArea = cv::Rect();
+            auto image = read();  // a cv::Mat or a frame's ImageView
+            if (shownArea.empty()) {
+                shownImage = image.size();
+                shownArea = cv::Rect(0, 0, shownImage.width, shownImage.height);
+            }
+            texture = cache.update(owner, index, image, fit);
+            shownVersion = version;
+            reload = false;
+        }
+        if (!texture) {
+            ImGui::Dummy(size);
+            return;
+        }
+        drawImage(title, texture);
+    }
+
+    // The preview of node's result, or of its partial result while it renders
+    void drawResult(const char* label, Node& node) {
+        node.viewRegion = zoomed ? view : cv::Rect();
+        draw(label, node.getName() + " (full resolution)", node.previewVersion(), [&] {
+            // A region result is placed in its image; a partial result in
+            // progress is always of the whole image
+            Frame frame = node.previewFrame();
+            if (frame.isRegion()) {
+                shownArea = frame.area();
+                shownImage = frame.imageSize();
+            }
+            return frame.view();
+        });
+    }
+
+private:
+    const void* owner;
+    int index;
+    ImVec2 size;
+    bool zoomable;
+    uint64_t shownVersion = 0;
+    bool reload = false;  // zoom changed, upload at the other resolution
+    bool zoomed = false;
+    cv::Rect shownArea;   // where the texture sits in the image it is part of
+    cv::Size shownImage;
+    cv::Rect view;        // region asked for while zoomed: the visible part and a margin
+
+    void drawImage(const std::string& title, GLuint texture) {
+        ImGui::Image((ImTextureID)(intptr_t)texture, size);
+        if (!zoomable) return;
+
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip(zoomed ? "Click to close the full resolution view" : "Click to view at full resolution");
+        }
+        bool toggled = ImGui::IsItemClicked();
+        if (toggled) zoomed = !zoomed;
+
+        // The texture still holds the thumbnail in the frame zoom is switched on
+        if (zoomed && !toggled) {
+            bool open = true;
+            ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_FirstUseEver);
+            if (ImGui::Begin(title.c_str(), &open, ImGuiWindowFlags_HorizontalScrollbar)) {
+                // The whole image sets the scroll range, the texture may only
+                // fill a region of it
+                ImVec2 origin = ImGui::GetCursorPos();
+                ImGui::Dummy(ImVec2(float(shownImage.width), float(shownImage.height)));
+                ImGui::SetCursorPos(ImVec2(origin.x + shownArea.x, origin.y + shownArea.y));
+                ImGui::Image((ImTextureID)(intptr_t)texture, ImVec2(float(shownArea.width), float(shownArea.height)));
+
+                ImVec2 window = ImGui::GetWindowSize();
+                cv::Rect visible(int(ImGui::GetScrollX() - origin.x), int(ImGui::GetScrollY() - origin.y),
+                                 int(window.x), int(window.y));
+                if ((view & visible) != visible) {
+                    view = TileGrid::grow(visible, std::max(visible.width, visible.height) / 2);
+                }
+            }
+            ImGui::End();
+            if (!open) {
+                zoomed = false;
+                toggled = true;
+            }
+        }
+        if (toggled) {
+            reload = true;
+            view = cv::Rect();
+        }
+    }
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <mutex>
+#include <utility>
+
+// Holds the last finished result of a node. A worker computes into its own
+// buffer and swaps it in with publish(); readers on other threads take a copy
+// with read() and never see a half-written value. For a Frame both sides are
+// just headers, so the lock only guards a refcount bump.
+template <typename T>
+class ResultSlot {
+public:
+    void publish(T value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(front, value);
+    }
+
+    T read() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return front;
+    }
+
+    // Empties the slot and returns what it held
+    T take() {
+        std::lock_guard<std::mutex> lock(mutex);
+        T value;
+        std::swap(front, value);
+        return value;
+    }
+
+private:
+    mutable std::mutex mutex;
+    T front;
+};
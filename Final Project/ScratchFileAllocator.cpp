@@ -0,0 +1,126 @@
+#include "ScratchFileAllocator.h"
+#include "AllocationScope.h"
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+ScratchFileAllocator::ScratchFileAllocator(const std::string& directory, size_t minSize, cv::MatAllocator* fallback)
+    : directory(directory), minSize(minSize), fallback(fallback ? fallback : cv::Mat::getStdAllocator()) {}
+
+ScratchFileAllocator& ScratchFileAllocator::install(const std::string& directory, size_t minSize) {
+    static ScratchFileAllocator* scratch = new ScratchFileAllocator(directory, minSize, cv::Mat::getDefaultAllocator());
+    CV_Assert(scratch->directory == directory && scratch->minSize == minSize);
+    cv::Mat::setDefaultAllocator(scratch);
+    return *scratch;
+}
+
+cv::UMatData* ScratchFileAllocator::allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                                             cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const {
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = 0; i < dims; i++) {
+        total *= sizes[i];
+    }
+
+    void* mapping = (data || total < minSize) ? nullptr : map(total);
+    if (!mapping) {
+        return fallback->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    if (step) {
+        size_t rowStep = CV_ELEM_SIZE(type);
+        for (int i = dims - 1; i >= 0; i--) {
+            step[i] = rowStep;
+            rowStep *= sizes[i];
+        }
+    }
+
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = static_cast<uchar*>(mapping);
+    u->size = total;
+    mapped += total;
+    AllocationScope::allocated(total);
+    return u;
+}
+
+bool ScratchFileAllocator::allocate(cv::UMatData* data, cv::AccessFlag, cv::UMatUsageFlags) const {
+    return data != nullptr;
+}
+
+void ScratchFileAllocator::deallocate(cv::UMatData* u) const {
+    if (!u) return;
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+
+    AllocationScope::released(u->size);
+    unmap(u->origdata, u->size);
+    mapped -= u->size;
+    u->origdata = nullptr;
+    delete u;
+}
+
+#ifdef _WIN32
+
+void* ScratchFileAllocator::map(size_t bytes) const {
+    char path[MAX_PATH];
+    if (!GetTempFileNameA(directory.c_str(), "nod", 0, path)) return nullptr;
+
+    // Deleted once the last handle, and the view, are gone
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        DeleteFileA(path);
+        return nullptr;
+    }
+    HANDLE section = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(uint64_t(bytes) >> 32),
+                                        static_cast<DWORD>(bytes & 0xffffffffu), nullptr);
+    void* view = section ? MapViewOfFile(section, FILE_MAP_ALL_ACCESS, 0, 0, bytes) : nullptr;
+    if (section) CloseHandle(section);
+    CloseHandle(file);
+    if (!view) std::cerr << "Cannot map a scratch file in " << directory << std::endl;
+    return view;
+}
+
+void ScratchFileAllocator::unmap(void* address, size_t) {
+    UnmapViewOfFile(address);
+}
+
+#else
+
+void* ScratchFileAllocator::map(size_t bytes) const {
+    std::string pattern = directory + "/nodescratchXXXXXX";
+    std::vector<char> path(pattern.begin(), pattern.end());
+    path.push_back('\0');
+
+    int fd = mkstemp(path.data());
+    if (fd < 0) {
+        std::cerr << "Cannot create a scratch file in " << directory << std::endl;
+        return nullptr;
+    }
+    unlink(path.data());  // the mapping keeps the file alive
+
+    // Reserve the blocks up front: a sparse file that runs out of disk later
+    // raises SIGBUS in whichever kernel touches the page, not a failed allocation
+    void* address = MAP_FAILED;
+    if (posix_fallocate(fd, 0, static_cast<off_t>(bytes)) == 0) {
+        address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    } else {
+        std::cerr << "Cannot reserve " << (bytes >> 20) << " MB of scratch space in " << directory << std::endl;
+    }
+    close(fd);
+    return address == MAP_FAILED ? nullptr : address;
+}
+
+void ScratchFileAllocator::unmap(void* address, size_t bytes) {
+    munmap(address, bytes);
+}
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+// cv::MatAllocator that backs large buffers with memory-mapped scratch files,
+// for images that do not fit in RAM. The OS pages the mapped buffers in and out
+// of the file as kernels touch them, so nodes keep working on plain cv::Mat
+// headers while the working set of the graph exceeds physical memory.
+//
+// Smaller buffers go to the allocator that was the default before install()
+// (normally the PooledMatAllocator). Scratch files are deleted as soon as they
+// are created and disappear with their mapping, even after a crash.
+class ScratchFileAllocator : public cv::MatAllocator {
+public:
+    static const size_t DEFAULT_MIN_SIZE = size_t(64) << 20;
+
+    ScratchFileAllocator(const std::string& directory, size_t minSize, cv::MatAllocator* fallback);
+
+    // Makes a process-wide instance the default allocator, spilling buffers of
+    // at least minSize bytes to directory. Never destroyed, see PooledMatAllocator.
+    // There is one instance per process, so later calls must pass the same arguments.
+    static ScratchFileAllocator& install(const std::string& directory, size_t minSize = DEFAULT_MIN_SIZE);
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* data) const override;
+
+    size_t mappedBytes() const { return mapped; }  // currently held in scratch files
+    const std::string& getDirectory() const { return directory; }
+
+private:
+    std::string directory;
+    size_t minSize;
+    cv::MatAllocator* fallback;
+    mutable std::atomic<size_t> mapped{0};
+
+    void* map(size_t bytes) const;  // nullptr if no scratch file could be mapped
+    static void unmap(void* address, size_t bytes);
+};
@@ -0,0 +1,264 @@
+#include "TextureCache.h"
+#include "ThreadPool.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace {
+// Pixel buffers in the ring: enough for every preview of the editor to
+// change in the same frame
+constexpr size_t RING_SIZE = 16;
+
+GLenum uploadFormat(int channels) {
+    switch (channels) {
+        case 1: return GL_LUMINANCE;
+        case 3: return GL_BGR;
+        case 4: return GL_BGRA;
+        default: return 0;
+    }
+}
+
+// What a texture uploaded in format stores: as many channels as the Mat, so
+// alpha is kept and grayscale takes a quarter of the memory
+GLint textureFormat(GLenum format) {
+    switch (format) {
+        case GL_LUMINANCE: return GL_LUMINANCE;
+        case GL_BGRA: return GL_RGBA;
+        default: return GL_RGB;
+    }
+}
+
+// The size image is uploaded at: scaled down to fit within fit, keeping the
+// aspect ratio, or as it is
+cv::Size uploadSize(const cv::Mat& image, cv::Size fit) {
+    if (fit.empty() || (image.cols <= fit.width && image.rows <= fit.height)) return image.size();
+    double scale = std::min(double(fit.width) / image.cols, double(fit.height) / image.rows);
+    return cv::Size(std::max(1, cvRound(image.cols * scale)), std::max(1, cvRound(image.rows * scale)));
+}
+
+// Writes image into pixels, which already has the upload size and is 8-bit.
+// INTER_AREA averages every source pixel, so thin edges and noise do not
+// alias the way nearest or linear would.
+void renderPixels(const cv::Mat& image, cv::Mat& pixels) {
+    cv::Mat scaled = image;
+    if (image.size() != pixels.size()) {
+        if (image.depth() == CV_8U) {
+            cv::resize(image, pixels, pixels.size(), 0, 0, cv::INTER_AREA);
+            return;
+        }
+        cv::resize(image, scaled, pixels.size(), 0, 0, cv::INTER_AREA);
+    }
+    scaled.convertTo(pixels, CV_8U);
+}
+}
+
+TextureCache::~TextureCache() {
+    clear();
+}
+
+TextureCache& TextureCache::shared() {
+    static TextureCache cache;
+    return cache;
+}
+
+void TextureCache::setStreaming(ThreadPool* streamingPool) {
+    finishTransfers();
+    pool = streamingPool;
+}
+
+GLuint TextureCache::update(const void* owner, int index, cv::InputArray source, cv::Size fit) {
+    // A header sharing the pixels, only ever read; the streaming worker keeps it
+    cv::Mat image = source.getMat();
+    if (image.empty()) {
+        release(owner, index);
+        return 0;
+    }
+
+    GLenum format = uploadFormat(image.channels());
+    if (!format) return 0;
+    cv::Size size = uploadSize(image, fit);
+
+    std::pair<const void*, int> slot(owner, index);
+    auto found = entries.find(slot);
+    if (found == entries.end()) {
+        found = entries.emplace(slot, Entry()).first;
+        found->second.sequence = sequence;  // transfers for a slot released earlier are stale
+        glGenTextures(1, &found->second.texture);
+        glBindTexture(GL_TEXTURE_2D, found->second.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    Entry& entry = found->second;
+    if (pool && stream(slot, image, size, format)) {
+        return entry.texture;
+    }
+
+    cv::Mat pixels = image;
+    if (size != image.size() || image.depth() != CV_8U) {
+        pixels.create(size, CV_8UC(image.channels()));
+        renderPixels(image, pixels);
+    }
+
+    // Rows start at multiples of the Mat's step; tell GL where they are
+    size_t step = pixels.step[0];
+    GLint alignment = step % 8 == 0 ? 8 : step % 4 == 0 ? 4 : step % 2 == 0 ? 2 : 1;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(step / pixels.elemSize()));
+    entry.sequence = ++sequence;
+    upload(entry, size, format, pixels.data);
+
+    // Back to GL's defaults, which other code (ImGui) relies on
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    return entry.texture;
+}
+
+bool TextureCache::stream(std::pair<const void*, int> slot, const cv::Mat& image, cv::Size size, GLenum format) {
+    if (ring.empty()) {
+        for (size_t i = 0; i < RING_SIZE; i++) {
+            ring.push_back(std::make_unique<Transfer>());
+            glGenBuffers(1, &ring.back()->buffer);
+        }
+    }
+    auto idle = std::find_if(ring.begin(), ring.end(),
+                             [](const std::unique_ptr<Transfer>& t) { return t->state == Transfer::Idle; });
+    if (idle == ring.end()) return false;
+    Transfer& transfer = **idle;
+
+    // Rows are packed tightly, so the upload reads them with an alignment of 1.
+    // Respecifying the store orphans the one a previous upload may still be
+    // reading, instead of waiting for it.
+    size_t bytes = size_t(size.width) * size_t(size.height) * size_t(image.channels());
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, transfer.buffer);
+    transfer.capacity = std::max(transfer.capacity, bytes);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, transfer.capacity, nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!mapped) return false;
+
+    transfer.slot = slot;
+    transfer.sequence = ++sequence;
+    transfer.size = size;
+    transfer.format = format;
+    transfer.state = Transfer::Filling;
+
+    // The worker holds a reference to the image, so it stays valid (and, being
+    // shared, is not written in place) until the pixels are copied
+    Transfer* target = &transfer;
+    pool->submit([target, image, mapped] {
+        try {
+            cv::Mat pixels(target->size, CV_8UC(image.channels()), mapped);
+            renderPixels(image, pixels);
+            target->state = Transfer::Filled;
+        } catch (...) {
+            target->state = Transfer::Failed;
+        }
+    });
+    return true;
+}
+
+void TextureCache::flush() {
+    // Apply in the order the updates were made, so the newest one of a slot wins
+    std::vector<Transfer*> ready;
+    for (auto& transfer : ring) {
+        int state = transfer->state;
+        if (state == Transfer::Filled || state == Transfer::Failed) ready.push_back(transfer.get());
+    }
+    std::sort(ready.begin(), ready.end(), [](Transfer* a, Transfer* b) { return a->sequence < b->sequence; });
+
+    for (Transfer* transfer : ready) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, transfer->buffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        auto it = entries.find(transfer->slot);
+        if (transfer->state == Transfer::Filled && it != entries.end() && transfer->sequence > it->second.sequence) {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            it->second.sequence = transfer->sequence;
+            upload(it->second, transfer->size, transfer->format, nullptr);  // from offset 0 of the buffer
+            counters.streamed++;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        transfer->state = Transfer::Idle;
+    }
+}
+
+void TextureCache::upload(Entry& entry, cv::Size size, GLenum format, const void* pixels) {
+    glBindTexture(GL_TEXTURE_2D, entry.texture);
+    GLint internalFormat = textureFormat(format);
+    if (entry.width != size.width || entry.height != size.height || entry.internalFormat != internalFormat) {
+        counters.bytes -= entry.bytes();
+        entry.width = size.width;
+        entry.height = size.height;
+        entry.internalFormat = internalFormat;
+        counters.bytes += entry.bytes();
+        counters.allocations++;
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size.width, size.height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.width, size.height, format, GL_UNSIGNED_BYTE, pixels);
+    }
+    counters.updates++;
+}
+
+void TextureCache::finishTransfers() {
+    for (auto& transfer : ring) {
+        while (transfer->state == Transfer::Filling) {
+            std::this_thread::yield();
+        }
+    }
+    flush();
+}
+
+GLuint TextureCache::texture(const void* owner, int index) const {
+    auto it = entries.find({owner, index});
+    return it != entries.end() ? it->second.texture : 0;
+}
+
+cv::Size TextureCache::size(const void* owner, int index) const {
+    auto it = entries.find({owner, index});
+    return it != entries.end() ? cv::Size(it->second.width, it->second.height) : cv::Size();
+}
+
+void TextureCache::release(const void* owner, int index) {
+    auto it = entries.find({owner, index});
+    if (it == entries.end()) return;
+    destroy(it->second);
+    entries.erase(it);
+}
+
+void TextureCache::release(const void* owner) {
+    auto it = entries.lower_bound({owner, std::numeric_limits<int>::min()});
+    while (it != entries.end() && it->first.first == owner) {
+        destroy(it->second);
+        it = entries.erase(it);
+    }
+}
+
+void TextureCache::clear() {
+    finishTransfers();
+    for (auto& transfer : ring) {
+        glDeleteBuffers(1, &transfer->buffer);
+    }
+    ring.clear();
+
+    for (auto& entry : entries) {
+        destroy(entry.second);
+    }
+    entries.clear();
+}
+
+size_t TextureCache::bytes(const void* owner) const {
+    size_t total = 0;
+    auto it = entries.lower_bound({owner, std::numeric_limits<int>::min()});
+    for (; it != entries.end() && it->first.first == owner; ++it) {
+        total += it->second.bytes();
+    }
+    return total;
+}
+
+void TextureCache::destroy(const Entry& entry) {
+    if (entry.texture) glDeleteTextures(1, &entry.texture);
+    counters.bytes -= entry.bytes();
+}
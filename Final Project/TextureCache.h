@@ -0,0 +1,115 @@
+#pragma once
+#include <GL/glew.h>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+// Keeps one GL texture per preview slot of the editor. A slot is any (owner,
+// index) pair, normally a *NodeUI and its n-th preview. Updating a slot with
+// an image of the size it already holds replaces the pixels in place with
+// glTexSubImage2D; the texture is only (re)allocated when the size or the
+// number of channels changes.
+//
+// 8-bit BGR, BGRA and grayscale Mats are uploaded as they are (GL_BGR,
+// GL_BGRA, GL_LUMINANCE), with the unpack alignment and row length taken from
+// the Mat, so odd widths and ROIs need no copy. Other depths are converted to
+// 8 bits first.
+//
+// Previews are drawn far smaller than the images they show. Given the size a
+// slot is displayed at, update() area-downscales (INTER_AREA) larger images to
+// fit it, so a 24 MP result costs a few hundred KB of texture instead of 72 MB;
+// the full resolution is only uploaded when no size is given (e.g. zoomed in).
+//
+// With streaming enabled, update() does not touch the pixels on the GL thread.
+// It maps one of a ring of pixel buffer objects and hands it to a worker,
+// which scales and converts the image straight into it; flush(), once per
+// frame, unmaps the filled buffers and issues the uploads from them, which the
+// driver copies without blocking the render thread. Until then a slot keeps
+// showing its previous pixels, and a new slot nothing. When every buffer of
+// the ring is in flight the upload falls back to the synchronous path.
+//
+// Only needs a current GL context, not ImGui, so it can be exercised on its own
+// (e.g. under Mesa's llvmpipe with LIBGL_ALWAYS_SOFTWARE=1). All calls must come
+// from the thread that owns the context.
+class TextureCache {
+public:
+    struct Stats {
+        size_t updates = 0;      // images uploaded
+        size_t allocations = 0;  // of those, uploads that had to (re)allocate storage
+        size_t bytes = 0;        // texture memory held (see Entry::bytes)
+        size_t streamed = 0;     // uploads that went through a pixel buffer
+    };
+
+    TextureCache() = default;
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // The editor's cache
+    static TextureCache& shared();
+
+    // Fills pixel buffers on pool's workers (see above); nullptr, the default,
+    // uploads synchronously. Waits for the transfers in flight.
+    void setStreaming(ThreadPool* pool);
+
+    // Uploads the pixel buffers the workers have filled. Call once per frame.
+    void flush();
+
+    // Uploads image to the slot's texture and returns it, scaled down to fit
+    // within fit when it is larger and fit is not empty. An empty image
+    // releases the slot and returns 0.
+    GLuint update(const void* owner, int index, cv::InputArray image, cv::Size fit = cv::Size());
+
+    GLuint texture(const void* owner, int index) const;  // 0 if the slot is empty
+    cv::Size size(const void* owner, int index) const;   // of the uploaded pixels
+    void release(const void* owner, int index);
+    void release(const void* owner);                     // every slot of owner
+    void clear();                                        // every slot and pixel buffer, before the context goes away
+
+    size_t bytes(const void* owner) const;
+    const Stats& stats() const { return counters; }
+
+private:
+    struct Entry {
+        GLuint texture = 0;
+        int width = 0;
+        int height = 0;
+        GLint internalFormat = 0;
+        uint64_t sequence = 0;  // of the update shown; older transfers are dropped
+
+        // Video memory held, taking RGB texels as padded to four bytes
+        size_t bytes() const { return size_t(width) * size_t(height) * (internalFormat == GL_LUMINANCE ? 1 : 4); }
+    };
+
+    // One pixel buffer of the ring
+    struct Transfer {
+        enum State { Idle, Filling, Filled, Failed };
+
+        GLuint buffer = 0;
+        size_t capacity = 0;
+        std::atomic<int> state{Idle};  // written by the worker while Filling
+        std::pair<const void*, int> slot;
+        uint64_t sequence = 0;
+        cv::Size size;
+        GLenum format = 0;
+    };
+
+    std::map<std::pair<const void*, int>, Entry> entries;
+    std::vector<std::unique_ptr<Transfer>> ring;
+    ThreadPool* pool = nullptr;
+    uint64_t sequence = 0;
+    Stats counters;
+
+    bool stream(std::pair<const void*, int> slot, const cv::Mat& image, cv::Size size, GLenum format);
+    void upload(Entry& entry, cv::Size size, GLenum format, const void* pixels);
+    void finishTransfers();
+    void destroy(const Entry& entry);
+};
@@ -0,0 +1,91 @@
+#include "ThreadPool.h"
+
+namespace {
+// Index of the pool worker running on this thread, or -1 for outside threads
+thread_local int currentWorker = -1;
+thread_local const ThreadPool* currentPool = nullptr;
+}
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) threadCount = 1;
+
+    for (unsigned i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned i = 0; i < threadCount; i++) {
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    unsigned index = (currentPool == this)
+        ? static_cast<unsigned>(currentWorker)
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % size();
+
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedTasks++;
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::popTask(unsigned index, std::function<void()>& task) {
+    // Own queue: newest first
+    {
+        WorkQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal: oldest first, starting with the next worker over
+    for (unsigned offset = 1; offset < size(); offset++) {
+        WorkQueue& victim = *queues[(index + offset) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    currentWorker = static_cast<int>(index);
+    currentPool = this;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping || queuedTasks > 0; });
+            if (queuedTasks == 0) return;  // stopping with nothing left to run
+            queuedTasks--;
+        }
+
+        // One task is reserved for this worker; it may sit in any queue
+        std::function<void()> task;
+        while (!popTask(index, task)) {
+            std::this_thread::yield();
+        }
+        task();
+    }
+}
@@ -1,33 +1,70 @@
 #pragma once
 #include "Node.h"
-#include <GL/glew.h>
+#include "ResultSlot.h"
 
 class ThresholdNode : public Node {
 public:
+    // Threshold parameters
+    struct Params {
+        int thresholdValue = 127;
+        int maxValue = 255;
+        int thresholdType = cv::THRESH_BINARY;
+        bool useOtsu = false;
+        bool useAdaptive = false;
+        int adaptiveMethod = cv::ADAPTIVE_THRESH_MEAN_C;
+        int blockSize = 11;
+        double C = 2.0;
+
+        auto tie() const {
+            return std::tie(thresholdValue, maxValue, thresholdType, useOtsu,
+                            useAdaptive, adaptiveMethod, blockSize, C);
+        }
+        bool operator==(const Params& other) const { return tie() == other.tie(); }
+        size_t hash() const { return hashTuple(tie()); }
+        void visit(ParamVisitor& v) {
+            v.field("thresholdValue", thresholdValue);
+            v.field("maxValue", maxValue);
+            v.field("thresholdType", thresholdType);
+            v.field("useOtsu", useOtsu);
+            v.field("useAdaptive", useAdaptive);
+            v.field("adaptiveMethod", adaptiveMethod);
+            v.field("blockSize", blockSize);
+            v.field("C", C);
+        }
+    };
+
     ThresholdNode(int id);
     void process() override;
-    cv::Mat getOutput() const override;
-    void drawUI() override;
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return output.take(); }
+    std::vector<Frame> results() const override { return {output.read(), histogramImage.read()}; }
+    size_t paramsHash() const override { return jobParams.hash(); }
+    const char* typeName() const override { return "ThresholdNode"; }
+    void visitParams(ParamVisitor& v) override { params.visit(v); }
 
+    // Otsu picks the threshold from the histogram of the whole image
+    int footprint() const override { return jobParams.useAdaptive ? jobParams.blockSize : jobParams.useOtsu ? 0 : 1; }
+    // The histogram is of the whole image, so tile and region jobs leave it empty
+    void beginTiles(cv::Size) override { histogramImage.take(); }
+    cv::Mat processTile(const ImageView& input, cv::Rect inputArea, cv::Rect area) override;
+    void publishTiles(Frame result) override { output.publish(std::move(result)); }
 
+    Params params;  // edited by the UI
 
-private:
-    cv::Mat output;
-    GLuint texture = 0;
-    GLuint histogramTexture = 0;
 
-    // Threshold parameters
-    int thresholdValue = 127;
-    int maxValue = 255;
-    int thresholdType = cv::THRESH_BINARY;
-    bool useOtsu = false;
-    bool useAdaptive = false;
-    int adaptiveMethod = cv::ADAPTIVE_THRESH_MEAN_C;
-    int blockSize = 11;
-    double C = 2.0;
+
+protected:
+    ResultSlot<Frame> output;
+    ResultSlot<Frame> histogramImage;
+
+private:
+    Params jobParams;  // snapshot read by process()
 
     // Methods
-    GLuint matToTexture(const cv::Mat& mat);
-    void updateHistogram(const cv::Mat& input);
-    void drawHistogram();
+    void captureParams() override { jobParams = params; }
+    void releaseResults() override {
+        output.take();
+        histogramImage.take();
+    }
+    void updateHistogram(const ImageView& input);
 };
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "ThresholdNodeUI.h"
+#include <imgui.h>
+#include <opencv2/imgproc.hpp>
+
+void ThresholdNodeUI::drawUI() {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
+    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
+    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom-right
+
+    // Gradient colors
+    ImVec4 color1 = ImVec4(75.0f / 255.0f, 66.0f / 255.0f, 8.0f / 255.0f, 1.0f);
+    ImVec4 color2 = ImVec4(0.0f / 255.0f, 0.0f / 255.0f, 0.0f / 255.0f, 1.0f);
+
+    draw_list->AddRectFilledMultiColor(p0, p1,
+        ImColor(color1), ImColor(color1),  // top left to top right
+        ImColor(color2), ImColor(color2)); // bottom left to bottom right
+
+    // UI on top
+    ImGui::SetCursorScreenPos(p0); 
+    // Input selection
+    ImGui::Text("Input Selection:");
+    if (ImGui::BeginCombo("Input Image##Threshold", 
+        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
+        
+        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
+            setInput(0, nullptr);
+            markDirty();
+        }
+        
+        for (Node* node : Node::availableNodes) {
+            if (node != this) {
+                bool is_selected = (inputs[0] == node);
+                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
+                    setInput(0, node);
+                    markDirty();
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+
+    // Threshold controls
+    ImGui::Text("Threshold Settings");
+
+    // Method selection
+    if (ImGui::Checkbox("Use Adaptive Threshold", &params.useAdaptive)) {
+        markDirty();
+    }
+
+    if (!params.useAdaptive) {
+        if (ImGui::Checkbox("Use Otsu's Method", &params.useOtsu)) {
+            markDirty();
+        }
+    }
+
+    if (!params.useAdaptive && !params.useOtsu) {
+        if (ImGui::SliderInt("Threshold Value", &params.thresholdValue, 0, 255)) {
+            markDirty();
+        }
+    }
+
+    if (ImGui::SliderInt("Max Value", &params.maxValue, 0, 255)) {
+        markDirty();
+    }
+
+    if (!params.useAdaptive) {
+        const char* types[] = { "Binary", "Binary Inverted", "Truncate", "To Zero", "To Zero Inverted" };
+        int currentType = params.thresholdType;
+        if (ImGui::Combo("Threshold Type", &currentType, types, IM_ARRAYSIZE(types))) {
+            params.thresholdType = currentType;
+            markDirty();
+        }
+    } else {
+        const char* methods[] = { "Mean", "Gaussian" };
+        int currentMethod = (params.adaptiveMethod == cv::ADAPTIVE_THRESH_MEAN_C) ? 0 : 1;
+        if (ImGui::Combo("Adaptive Method", &currentMethod, methods, IM_ARRAYSIZE(methods))) {
+            params.adaptiveMethod = (currentMethod == 0) ? cv::ADAPTIVE_THRESH_MEAN_C : cv::ADAPTIVE_THRESH_GAUSSIAN_C;
+            markDirty();
+        }
+
+        if (ImGui::SliderInt("Block Size", &params.blockSize, 3, 99, "%d", ImGuiSliderFlags_AlwaysClamp)) {
+            // Ensure block size is odd
+            params.blockSize = (params.blockSize / 2) * 2 + 1;
+            markDirty();
+        }
+
+        float cValue = (float)params.C;
+        if (ImGui::SliderFloat("C", &cValue, -10.0f, 10.0f)) {
+            params.C = (double)cValue;
+            markDirty();
+}
+    }
+
+    // Display histogram
+    histogramPreview.draw("Histogram:", "", generation, [&] { return histogramImage.read().view(); });
+
+    // Display result
+    resultPreview.drawResult("Result:", *this);
+}
\ No newline at end of file
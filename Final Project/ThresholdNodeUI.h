@@ -0,0 +1,17 @@
+#pragma once
+#include "ThresholdNode.h"
+#include "PreviewImage.h"
+#include "TextureCache.h"
+#include <GL/glew.h>
+
+// Editor front end for ThresholdNode: ImGui controls, result and histogram textures
+class ThresholdNodeUI : public ThresholdNode {
+public:
+    using ThresholdNode::ThresholdNode;
+    void drawUI() override;
+    size_t textureBytes() const override { return TextureCache::shared().bytes(this); }
+
+private:
+    PreviewImage resultPreview{this, 0, ImVec2(300, 300)};
+    PreviewImage histogramPreview{this, 1, ImVec2(256, 100), false};
+};
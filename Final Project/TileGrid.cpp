@@ -0,0 +1,25 @@
+#include "TileGrid.h"
+#include <algorithm>
+
+std::vector<cv::Rect> TileGrid::tiles(cv::Size size, int tileSize) {
+    std::vector<cv::Rect> result;
+    for (int y = 0; y < size.height; y += tileSize) {
+        for (int x = 0; x < size.width; x += tileSize) {
+            result.emplace_back(x, y, std::min(tileSize, size.width - x), std::min(tileSize, size.height - y));
+        }
+    }
+    return result;
+}
+
+std::vector<cv::Rect> TileGrid::centreFirst(cv::Size size, int tileSize) {
+    std::vector<cv::Rect> result = tiles(size, tileSize);
+    auto distance = [&](const cv::Rect& tile) {
+        double dx = tile.x + tile.width * 0.5 - size.width * 0.5;
+        double dy = tile.y + tile.height * 0.5 - size.height * 0.5;
+        return dx * dx + dy * dy;
+    };
+    // Stable, so tiles at the same distance keep reading order
+    std::stable_sort(result.begin(), result.end(),
+                     [&](const cv::Rect& a, const cv::Rect& b) { return distance(a) < distance(b); });
+    return result;
+}
\ No newline at end of file
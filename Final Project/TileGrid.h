@@ -0,0 +1,22 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+// Splits an image into square tiles for kernels that work a piece at a time
+class TileGrid {
+public:
+    static constexpr int DEFAULT_TILE_SIZE = 256;
+
+    // Every tile of an image of size, row by row. Tiles on the right and
+    // bottom edges are cut to the image.
+    static std::vector<cv::Rect> tiles(cv::Size size, int tileSize = DEFAULT_TILE_SIZE);
+
+    // The same tiles, nearest to the centre of the image first: the order a
+    // progressive preview fills in, since that is where the eye goes
+    static std::vector<cv::Rect> centreFirst(cv::Size size, int tileSize = DEFAULT_TILE_SIZE);
+
+    // area with margin more pixels on every side
+    static cv::Rect grow(cv::Rect area, int margin) {
+        return cv::Rect(area.x - margin, area.y - margin, area.width + 2 * margin, area.height + 2 * margin);
+    }
+};
@@ -1,121 +1,70 @@
-#include "BlurNode.h"
-#include <imgui.h>
+#include "blurnode.h"
+#include "TileGrid.h"
 #include <opencv2/imgproc.hpp>
 
 BlurNode::BlurNode(int id) : Node(id, "Blur") {
     inputs.resize(1);  // One input for image
-    radius = 5;
-    directionalBlur = false;
-    angle = 0.0f;
-    texture = 0;
-    kernelTexture = 0;
 }
 
 void BlurNode::process() {
     std::cout << "Processing Blur Node..." << std::endl;
     
-    if (inputs[0]) {
-        cv::Mat input = inputs[0]->getOutput();
+    if (boundInputs[0]) {
+        Frame inputFrame = takeInput(0);
+        ImageView input = inputFrame.view();
         if (!input.empty()) {
-            // Create kernel based on current settings
-            cv::Mat kernel;
-            if (directionalBlur) {
-                kernel = createDirectionalKernel(2 * radius + 1, angle);
-            } else {
-                kernel = createGaussianKernel(2 * radius + 1, radius/3.0);
-            }
+            // Create kernel based on the settings this job was submitted with
+            // The radius is in full resolution pixels; on a proxy it shrinks with the image
+            double radius = double(jobParams.radius) / jobScale;
+            cv::Mat kernel = createKernel(radius);
 
             // Apply filter
-            cv::filter2D(input, output, -1, kernel);
-
-            // Update textures
-            if (texture) {
-                glDeleteTextures(1, &texture);
+            cv::Mat result;
+            if (renderProgressively(input.size())) {
+                // A coarse pass, blurred at 1/COARSE_STEP size and scaled back
+                // up, then the exact blur a tile at a time, centre first.
+                // filter2D reads the pixels around a tile from the rest of
+                // the image, so the tiles join up seamlessly.
+                cv::Mat small, coarse;
+                cv::resize(input, small, cv::Size(), 1.0 / COARSE_STEP, 1.0 / COARSE_STEP, cv::INTER_AREA);
+                cv::filter2D(small, coarse, -1, createKernel(radius / COARSE_STEP));
+                cv::resize(coarse, result, input.size(), 0, 0, cv::INTER_LINEAR);
+                publishProgress(result, true);
+
+                for (const cv::Rect& tile : TileGrid::centreFirst(input.size())) {
+                    if (cancelled()) return;
+                    cv::Mat target = result(tile);
+                    cv::filter2D(input(tile), target, -1, kernel);
+                    publishProgress(result);
+                }
+            } else {
+                cv::filter2D(input, result, -1, kernel);
             }
-            texture = matToTexture(output);
-
-            // Update kernel preview
-            updateKernelPreview();
+            output.publish(Frame(std::move(result), jobScale));
         } else {
-            output = cv::Mat();  // Clear output if input is empty
+            output.publish(Frame());  // Clear output if input is empty
         }
     } else {
-        output = cv::Mat();  // Clear output if no input is connected
+        output.publish(Frame());  // Clear output if no input is connected
     }
-    
-    dirty = false;
 }
 
-void BlurNode::drawUI() {
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
-    ImVec2 p0 = ImGui::GetCursorScreenPos();  // top left of content region
-    ImVec2 size = ImGui::GetContentRegionAvail();  // drawable area
-    ImVec2 p1 = ImVec2(p0.x + size.x, p0.y + size.y);  // bottom right
-
-    // Gradient colors
-    ImVec4 color1 = ImVec4(106.0f / 255.0f, 90.0f / 255.0f, 205.0f / 255.0f, 1.0f);
-    ImVec4 color2 = ImVec4(48.0f / 255.0f, 25.0f / 255.0f, 52.0f / 255.0f, 1.0f);
-
-    draw_list->AddRectFilledMultiColor(p0, p1,
-        ImColor(color1), ImColor(color1),  // top left to top right
-        ImColor(color2), ImColor(color2)); // bottom left to bottom right
-
-    // UI on top
-    ImGui::SetCursorScreenPos(p0); 
-    // Input selection
-    ImGui::Text("Input Selection:");
-    if (ImGui::BeginCombo("Input Image##Blur", 
-        inputs[0] ? inputs[0]->getName().c_str() : "None")) {
-        
-        if (ImGui::Selectable("None", inputs[0] == nullptr)) {
-            setInput(0, nullptr);
-            markDirty();
-        }
-        
-        for (Node* node : Node::availableNodes) {
-            if (node != this) {
-                bool is_selected = (inputs[0] == node);
-                if (ImGui::Selectable(node->getName().c_str(), is_selected)) {
-                    setInput(0, node);
-                    markDirty();
-                }
-            }
-        }
-        ImGui::EndCombo();
-    }
-
-    // Blur controls
-    ImGui::Text("Blur Settings");
-    
-    if (ImGui::SliderInt("Radius", &radius, 1, 20)) {
-        markDirty();
-    }
-
-    if (ImGui::Checkbox("Directional Blur", &directionalBlur)) {
-        markDirty();
-    }
-
-    if (directionalBlur) {
-        if (ImGui::SliderFloat("Angle", &angle, 0.0f, 360.0f)) {
-            markDirty();
-        }
-    }
-
-    // Display kernel preview
-    if (kernelTexture) {
-        ImGui::Text("Kernel Preview:");
-        ImGui::Image((ImTextureID)(intptr_t)kernelTexture, ImVec2(100, 100));
-    }
+Frame BlurNode::getOutput() const {
+    return output.read();
+}
 
-    // Display result preview
-    if (texture) {
-        ImGui::Text("Result Preview:");
-        ImGui::Image((ImTextureID)(intptr_t)texture, ImVec2(300, 300));
-    }
+cv::Mat BlurNode::processTile(const ImageView& input, cv::Rect inputArea, cv::Rect area) {
+    cv::Mat result;
+    cv::filter2D(input(area - inputArea.tl()), result, -1, createKernel(double(jobParams.radius) / jobScale));
+    return result;
 }
 
-cv::Mat BlurNode::getOutput() const {
-    return output;
+cv::Mat BlurNode::createKernel(double radius) {
+    int size = kernelSize(radius);
+    if (jobParams.directionalBlur) {
+        return createDirectionalKernel(size, jobParams.angle);
+    }
+    return createGaussianKernel(size, radius/3.0);
 }
 
 cv::Mat BlurNode::createGaussianKernel(int size, double sigma) {
@@ -142,50 +91,4 @@ cv::Mat BlurNode::createDirectionalKernel(int size, float angle) {
     // Normalize kernel
     kernel = kernel / cv::sum(kernel)[0];
     return kernel;
-}
-
-void BlurNode::updateKernelPreview() {
-    cv::Mat kernel;
-    if (directionalBlur) {
-        kernel = createDirectionalKernel(2 * radius + 1, angle);
-    } else {
-        kernel = createGaussianKernel(2 * radius + 1, radius/3.0);
-    }
-    
-    // Normalize for display
-    cv::Mat kernelDisplay;
-    cv::normalize(kernel, kernelDisplay, 0, 255, cv::NORM_MINMAX);
-    kernelDisplay.convertTo(kernelDisplay, CV_8U);
-    
-    // Convert to RGB
-    cv::Mat kernelRGB;
-    cv::cvtColor(kernelDisplay, kernelRGB, cv::COLOR_GRAY2RGB);
-    
-    // Update texture
-    if (kernelTexture) {
-        glDeleteTextures(1, &kernelTexture);
-    }
-    kernelTexture = matToTexture(kernelRGB);
-}
-
-GLuint BlurNode::matToTexture(const cv::Mat& mat) {
-    cv::Mat rgbMat;
-    GLenum format;
-
-    if (mat.channels() == 3) {
-        cv::cvtColor(mat, rgbMat, cv::COLOR_BGR2RGB);
-        format = GL_RGB;
-    } else {
-        rgbMat = mat;
-        format = GL_LUMINANCE;
-    }
-
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, rgbMat.cols, rgbMat.rows, 0, format, GL_UNSIGNED_BYTE, rgbMat.data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    return textureID;
 }
\ No newline at end of file
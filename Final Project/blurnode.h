@@ -1,29 +1,53 @@
 #pragma once
 #include "Node.h"
-#include <GL/glew.h>
+#include "ResultSlot.h"
 
 class BlurNode : public Node {
 public:
+    // Blur parameters
+    struct Params {
+        int radius = 5;            // 1-20px
+        bool directionalBlur = false;
+        float angle = 0.0f;        // For directional blur
+
+        auto tie() const { return std::tie(radius, directionalBlur, angle); }
+        bool operator==(const Params& other) const { return tie() == other.tie(); }
+        size_t hash() const { return hashTuple(tie()); }
+        void visit(ParamVisitor& v) {
+            v.field("radius", radius);
+            v.field("directionalBlur", directionalBlur);
+            v.field("angle", angle);
+        }
+    };
+
     BlurNode(int id);
     void process() override;
-    cv::Mat getOutput() const override;
-    void drawUI() override;
+    Frame getOutput() const override;
+    Frame releaseOutput() override { return output.take(); }
+    size_t paramsHash() const override { return jobParams.hash(); }
+    const char* typeName() const override { return "BlurNode"; }
+    void visitParams(ParamVisitor& v) override { params.visit(v); }
 
+    int footprint() const override { return kernelSize(double(jobParams.radius) / jobScale); }
+    cv::Mat processTile(const ImageView& input, cv::Rect inputArea, cv::Rect area) override;
+    void publishTiles(Frame result) override { output.publish(std::move(result)); }
 
+    Params params;  // edited by the UI
 
-private:
-    cv::Mat output;
-    GLuint texture = 0;
-    GLuint kernelTexture = 0;  // For displaying the kernel
+protected:
+    ResultSlot<Frame> output;
 
-    // Blur parameters
-    int radius = 5;            // 1-20px
-    bool directionalBlur = false;
-    float angle = 0.0f;        // For directional blur
-    
-    // Methods
-    GLuint matToTexture(const cv::Mat& mat);
-    void updateKernelPreview();
+    // Coarse progressive pass: blurred at 1/COARSE_STEP of the size
+    static constexpr int COARSE_STEP = 8;
+
+    // Blur or directional kernel for the job's parameters at radius
+    static int kernelSize(double radius) { return 2 * std::max(1, cvRound(radius)) + 1; }
+    cv::Mat createKernel(double radius);
     cv::Mat createGaussianKernel(int size, double sigma);
     cv::Mat createDirectionalKernel(int size, float angle);
-};
\ No newline at end of file
+
+private:
+    Params jobParams;  // snapshot read by process()
+
+    void captureParams() override { jobParams = params; }
+};
@@ -4,22 +4,57 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
-#include "LoadImageNode.h"
-#include "BrightnessContrastNode.h"
-#include "ColorChannelSplitNode.h"
-#include "blurnode.h"
-#include "ThresholdNode.h"
-#include "EdgeDetectionNode.h"
-#include "BlendNode.h"
-#include "NoiseGenerationNode.h"
-#include "ConvolutionFilterNode.h"
-#include "OutputNode.h"
-
+#include "LoadImageNodeUI.h"
+#include "BrightnessContrastNodeUI.h"
+#include "ColorChannelSplitNodeUI.h"
+#include "BlurNodeUI.h"
+#include "ThresholdNodeUI.h"
+#include "EdgeDetectionNodeUI.h"
+#include "BlendNodeUI.h"
+#include "NoiseGenerationNodeUI.h"
+#include "ConvolutionFilterNodeUI.h"
+#include "OutputNodeUI.h"
+#include "GraphExecutor.h"
+#include "ThreadPool.h"
+#include "AsyncEvaluator.h"
+#include "GraphSerializer.h"
+#include "PooledMatAllocator.h"
+#include "MemoryBudget.h"
+#include "ScratchFileAllocator.h"
+#include "MemoryReport.h"
+#include "TextureCache.h"
+#include "tinyfiledialogs.h"
+#include <algorithm>
+#include <iostream>
+
+
+
+// Writes the editor's graph for nodebatch; a .graphb extension selects the binary form
+static void saveGraphDialog() {
+    const char* filters[2] = { "*.graph", "*.graphb" };
+    const char* selected = tinyfd_saveFileDialog("Save Graph", "pipeline.graph", 2, filters, "Node graphs");
+    if (!selected) return;
+
+    std::string path = selected;
+    bool binary = path.size() >= 7 && path.compare(path.size() - 7, 7, ".graphb") == 0;
+    try {
+        GraphSerializer::saveFile(path, Node::availableNodes,
+            binary ? GraphSerializer::Format::Binary : GraphSerializer::Format::Text);
+    } catch (const std::exception& ex) {
+        std::cerr << "Error saving graph: " << ex.what() << std::endl;
+    }
+}
 
+int main(int argc, char** argv) {
+    // Every edit reallocates full-size Mats; recycle them instead of going to the heap
+    PooledMatAllocator::install();
 
+    // --scratch <dir> keeps large images in files mapped from dir, for inputs bigger than RAM
+    ScratchFileAllocator* scratch = nullptr;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--scratch") scratch = &ScratchFileAllocator::install(argv[i + 1]);
+    }
 
-int main() {
-    
     if (!glfwInit()) return -1;
     GLFWwindow* window = glfwCreateWindow(1500, 720, "Node Editor - LoadImageNode Test", nullptr, nullptr);
     if (!window) return -1;
@@ -38,16 +73,16 @@ int main() {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init("#version 130");
 
-    LoadImageNode node(1);
-    BrightnessContrastNode bcNode(2);
-    ColorChannelSplitNode channelNode(3);
-    BlurNode blurNode(4);
-    ThresholdNode threshNode(5);
-    EdgeDetectionNode edgeNode(6);
-    BlendNode blendNode(7);
-    NoiseGenerationNode noiseNode(8);
-    ConvolutionFilterNode convNode(9);
-    OutputNode outputNode(10);
+    LoadImageNodeUI node(1);
+    BrightnessContrastNodeUI bcNode(2);
+    ColorChannelSplitNodeUI channelNode(3);
+    BlurNodeUI blurNode(4);
+    ThresholdNodeUI threshNode(5);
+    EdgeDetectionNodeUI edgeNode(6);
+    BlendNodeUI blendNode(7);
+    NoiseGenerationNodeUI noiseNode(8);
+    ConvolutionFilterNodeUI convNode(9);
+    OutputNodeUI outputNode(10);
 
     // Register nodes
     Node::clearNodes();
@@ -62,8 +97,31 @@ int main() {
     Node::registerNode(&convNode);
     Node::registerNode(&outputNode);
 
+    // Nodes are processed on background threads, independent branches in
+    // parallel; only the texture uploads in drawUI() happen on this thread
+    ThreadPool pool;
+    GraphExecutor executor(&pool);
+    // Results beyond the budget are dropped and recomputed when needed again
+    int budgetMB = 4096;
+    MemoryBudget memoryBudget(size_t(budgetMB) << 20);
+    executor.setMemoryBudget(&memoryBudget);
+    executor.setProgressive(true);  // slow nodes fill their previews in as they go
+    AsyncEvaluator evaluator(executor);
+
+    // Previews are scaled into pixel buffers on a thread of their own, so
+    // neither node jobs nor the render thread wait for them
+    ThreadPool texturePool(1);
+    TextureCache::shared().setStreaming(&texturePool);
+
+    // Nodes whose results are wanted this frame: the Output node, which is
+    // always computed, and every node whose window is open and not collapsed.
+    // Only those windows are drawn, and so only they upload previews.
+    std::vector<Node*> requested;
+
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
+        requested.assign(1, &outputNode);
+        TextureCache::shared().flush();  // previews filled since the last frame
 
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -83,107 +141,139 @@ int main() {
         
         ImGui::SetNextWindowSize(ImVec2(350,380), ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(10,10), ImGuiCond_Once);
-        ImGui::Begin("Input Node");
-        node.drawUI();
-        ImGui::End();
-        
-        
-
-        if (node.dirty) {
-            node.process();
-        }
-
-        if (bcNode.dirty || (bcNode.inputs[0] && bcNode.inputs[0]->dirty)) {
-            bcNode.process();
-        }
-
-        if (channelNode.dirty || (channelNode.inputs[0] && channelNode.inputs[0]->dirty)) {
-            channelNode.process();
-        }
-
-
-        if (blurNode.dirty || (blurNode.inputs[0] && blurNode.inputs[0]->dirty)) {
-            blurNode.process();
-        }
-
-        if (threshNode.dirty || (threshNode.inputs[0] && threshNode.inputs[0]->dirty)) {
-            threshNode.process();
-        }
-
-        if(edgeNode.dirty || (edgeNode.inputs[0] && edgeNode.inputs[0]->dirty)) {
-            edgeNode.process();
-        }
-
-        if (blendNode.dirty || (blendNode.inputs[0] && blendNode.inputs[0]->dirty)) {
-            blendNode.process();
-        }
-
-        if (noiseNode.dirty) {
-            noiseNode.process();
-        }
-
-        if (convNode.dirty || (convNode.inputs[0] && convNode.inputs[0]->dirty)) {
-            convNode.process();
-        }
-
-        if (outputNode.dirty || (outputNode.inputs[0] && outputNode.inputs[0]->dirty)) {
-            outputNode.process();
+        if (ImGui::Begin("Input Node")) {
+            requested.push_back(&node);
+            node.drawUI();
         }
+        ImGui::End();
         
         ImGui::SetNextWindowSize(ImVec2(350,640), ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(10,400), ImGuiCond_Once);
-        ImGui::Begin("BrightnessContrast Node Test");
-        bcNode.drawUI();
+        if (ImGui::Begin("BrightnessContrast Node Test")) {
+            requested.push_back(&bcNode);
+            bcNode.drawUI();
+        }
         ImGui::End();
 
         ImGui::SetNextWindowSize(ImVec2(350,380), ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(370,10), ImGuiCond_Once);
-        ImGui::Begin("Color Channel Split Node");
-        channelNode.drawUI();
+        if (ImGui::Begin("Color Channel Split Node")) {
+            requested.push_back(&channelNode);
+            channelNode.drawUI();
+        }
         ImGui::End();
 
         ImGui::SetNextWindowSize(ImVec2(350,640),ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(370,400), ImGuiCond_Once);
-        ImGui::Begin("Blur Node");
-        blurNode.drawUI();
+        if (ImGui::Begin("Blur Node")) {
+            requested.push_back(&blurNode);
+            blurNode.drawUI();
+        }
         ImGui::End();
 
         ImGui::SetNextWindowSize(ImVec2(350,640),ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(730,400), ImGuiCond_Once);
-        ImGui::Begin("Threshold Node");
-        threshNode.drawUI();
+        if (ImGui::Begin("Threshold Node")) {
+            requested.push_back(&threshNode);
+            threshNode.drawUI();
+        }
         ImGui::End();
 
         ImGui::SetNextWindowSize(ImVec2(350,380),ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(730,10), ImGuiCond_Once);
-        ImGui::Begin("Edge Detection Node");
-        edgeNode.drawUI();
+        if (ImGui::Begin("Edge Detection Node")) {
+            requested.push_back(&edgeNode);
+            edgeNode.drawUI();
+        }
         ImGui::End();
         
         ImGui::SetNextWindowSize(ImVec2(350,640),ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(1090,400), ImGuiCond_Once);
-        ImGui::Begin("Blend Node");
-        blendNode.drawUI();
+        if (ImGui::Begin("Blend Node")) {
+            requested.push_back(&blendNode);
+            blendNode.drawUI();
+        }
         ImGui::End();
 
         ImGui::SetNextWindowSize(ImVec2(350,640),ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(1450,400), ImGuiCond_Once);
-        ImGui::Begin("Noise Generation Node");
-        noiseNode.drawUI();
+        if (ImGui::Begin("Noise Generation Node")) {
+            requested.push_back(&noiseNode);
+            noiseNode.drawUI();
+        }
         ImGui::End();
 
         ImGui::SetNextWindowSize(ImVec2(350,380),ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(1090,10), ImGuiCond_Once);
-        ImGui::Begin("Convolution Filter Node");
-        convNode.drawUI();
+        if (ImGui::Begin("Convolution Filter Node")) {
+            requested.push_back(&convNode);
+            convNode.drawUI();
+        }
         ImGui::End();
 
         ImGui::SetNextWindowSize(ImVec2(350,380),ImGuiCond_Once);
         ImGui::SetNextWindowPos(ImVec2(1450,10), ImGuiCond_Once);
-        ImGui::Begin("Output Node");
-        outputNode.drawUI();
+        if (ImGui::Begin("Output Node")) {
+            requested.push_back(&outputNode);
+            outputNode.drawUI();
+        }
         ImGui::End();
 
+        ImGui::SetNextWindowSize(ImVec2(300,120),ImGuiCond_Once);
+        ImGui::SetNextWindowPos(ImVec2(1450,1050), ImGuiCond_Once);
+        ImGui::Begin("Graph");
+        if (ImGui::Button("Save Graph")) {
+            saveGraphDialog();
+        }
+        PooledMatAllocator::Stats poolStats = PooledMatAllocator::instance().stats();
+        ImGui::Text("Buffer pool: %.0f%% reused, %.1f MB free",
+                    poolStats.hitRate() * 100.0, poolStats.pooledBytes / (1024.0 * 1024.0));
+        if (ImGui::SliderInt("Memory budget", &budgetMB, 0, 65536, budgetMB ? "%d MB" : "unlimited")) {
+            memoryBudget.setBudget(size_t(budgetMB) << 20);
+        }
+        ImGui::Text("Results: %.1f MB (peak %.1f MB), %zu evicted",
+                    memoryBudget.residentBytes() / (1024.0 * 1024.0),
+                    memoryBudget.peakResidentBytes() / (1024.0 * 1024.0), memoryBudget.evictions());
+        if (executor.getProxyScale() > 1) {
+            ImGui::Text("Previewing at 1/%d resolution", executor.getProxyScale());
+        }
+        const TextureCache::Stats& textureStats = TextureCache::shared().stats();
+        ImGui::Text("Textures: %.1f MB, %zu of %zu uploads reallocated, %zu streamed",
+                    textureStats.bytes / (1024.0 * 1024.0), textureStats.allocations, textureStats.updates,
+                    textureStats.streamed);
+        if (scratch) {
+            ImGui::Text("Scratch files: %.1f MB mapped", scratch->mappedBytes() / (1024.0 * 1024.0));
+        }
+        if (ImGui::CollapsingHeader("Memory by node")) {
+            // Held: results, caches and textures. Peak: transient allocations of
+            // the last run, and the highest seen so far.
+            ImGui::Columns(4, "memory");
+            ImGui::Text("Node"); ImGui::NextColumn();
+            ImGui::Text("Held MB"); ImGui::NextColumn();
+            ImGui::Text("Peak MB"); ImGui::NextColumn();
+            ImGui::Text("High MB"); ImGui::NextColumn();
+            ImGui::Separator();
+            for (const MemoryReport::Entry& entry : MemoryReport::collect(Node::availableNodes)) {
+                ImGui::Text("%s", entry.node->getName().c_str()); ImGui::NextColumn();
+                ImGui::Text("%.1f", entry.heldBytes() / (1024.0 * 1024.0)); ImGui::NextColumn();
+                ImGui::Text("%.1f", entry.lastPeakBytes / (1024.0 * 1024.0)); ImGui::NextColumn();
+                ImGui::Text("%.1f", entry.highWaterBytes / (1024.0 * 1024.0)); ImGui::NextColumn();
+            }
+            ImGui::Columns(1);
+        }
+        ImGui::End();
+
+        // While a slider is dragged the graph runs on a 1/4 proxy (1/8 for images
+        // over 32 MP) so that it keeps up; releasing it refines at full resolution
+        bool dragging = std::any_of(requested.begin(), requested.end(), [](Node* n) { return n->interacting; });
+        if (dragging != (executor.getProxyScale() > 1)) {
+            int proxyScale = node.getOutput().size().area() > 32 * 1000 * 1000 ? 8 : 4;
+            executor.setProxyScale(dragging ? proxyScale : 1);
+        }
+
+        // Only what the visible windows and the Output node depend on is computed
+        evaluator.update(Node::availableNodes, requested);
+
         ImGui::Render();
         int display_w, display_h;
         glfwGetFramebufferSize(window, &display_w, &display_h);
@@ -194,7 +284,9 @@ int main() {
         glfwSwapBuffers(window);
     }
 
-    // Cleanup
+    // Cleanup; the cache outlives texturePool, so it must stop using it first
+    TextureCache::shared().setStreaming(nullptr);
+    TextureCache::shared().clear();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
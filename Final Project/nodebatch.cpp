@@ -0,0 +1,267 @@
+#include "GraphSerializer.h"
+#include "GraphExecutor.h"
+#include "LoadImageNode.h"
+#include "OutputNode.h"
+#include "MemoryReport.h"
+#include "PooledMatAllocator.h"
+#include "ScratchFileAllocator.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// Applies a saved graph to many images without a display:
+//
+//   nodebatch <graph> <input>... -o <output dir> [-j <images in flight>] [--scratch <dir>] [--memory]
+//
+// The graph may be in the text or the binary form. An input is an image, a directory (its images are taken in name order) or a
+// .txt file listing one path per line. Every LoadImageNode in the graph reads the
+// current image and every OutputNode writes <name>.<format> to the output
+// directory (<name>_<node id>.<format> when the graph has several outputs).
+// Two inputs with the same name (a/img.png and b/img.jpg) would overwrite each
+// other's results, so the batch refuses to start.
+//
+// Each image in flight gets its own copy of the graph, so memory use is bounded
+// by the number of copies times one image's intermediates, whatever the size of
+// the batch. With --scratch, images too large for RAM are processed in buffers
+// mapped from scratch files in dir, see ScratchFileAllocator. --memory prints
+// the memory each node held and its peak allocations over the batch.
+
+namespace fs = std::filesystem;
+
+namespace {
+struct Pipeline {
+    GraphSerializer::NodeList owned;
+    std::vector<Node*> nodes;
+    std::vector<LoadImageNode*> sources;
+    std::vector<OutputNode*> sinks;
+    std::vector<Node*> requested;  // the sinks; branches that feed none of them are skipped
+};
+
+bool isImage(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext == ".jpg" || ext == ".jpeg" || ext == ".png" || ext == ".bmp" ||
+           ext == ".tif" || ext == ".tiff" || ext == ".webp";
+}
+
+void collectInputs(const fs::path& input, std::vector<fs::path>& files) {
+    if (fs::is_directory(input)) {
+        std::vector<fs::path> found;
+        for (const auto& entry : fs::directory_iterator(input)) {
+            if (entry.is_regular_file() && isImage(entry.path())) found.push_back(entry.path());
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    } else if (input.extension() == ".txt") {
+        std::ifstream list(input);
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            // Relative entries are relative to the list, not to the working directory
+            fs::path entry = line;
+            files.push_back(entry.is_relative() ? input.parent_path() / entry : entry);
+        }
+    } else {
+        files.push_back(input);
+    }
+}
+
+Pipeline instantiate(const std::string& graphText, const NodeFactory& factory) {
+    Pipeline pipeline;
+    std::istringstream in(graphText);
+    pipeline.owned = GraphSerializer::load(in, factory);
+    for (auto& node : pipeline.owned) {
+        pipeline.nodes.push_back(node.get());
+        if (auto* source = dynamic_cast<LoadImageNode*>(node.get())) pipeline.sources.push_back(source);
+        if (auto* sink = dynamic_cast<OutputNode*>(node.get())) {
+            pipeline.sinks.push_back(sink);
+            pipeline.requested.push_back(sink);
+        }
+    }
+    return pipeline;
+}
+
+// Runs one image through the pipeline; false if any output came out empty or could not be written
+bool processImage(Pipeline& pipeline, GraphExecutor& executor, const fs::path& file, const fs::path& outputDir) {
+    for (LoadImageNode* source : pipeline.sources) {
+        source->params.filePath = file.string();
+        source->markDirty();
+    }
+    executor.evaluate(pipeline.nodes, pipeline.requested);
+
+    bool ok = true;
+    for (OutputNode* sink : pipeline.sinks) {
+        std::string name = file.stem().string();
+        if (pipeline.sinks.size() > 1) name += "_" + std::to_string(sink->id);
+        ok = sink->saveImage((outputDir / (name + sink->fileExtension())).string()) && ok;
+    }
+    return ok;
+}
+
+int usage() {
+    std::cerr << "usage: nodebatch <graph> <input>... -o <output dir> [-j <images in flight>] [--scratch <dir>]"
+                 " [--memory]" << std::endl;
+    return 2;
+}
+}
+
+int main(int argc, char** argv) {
+    std::string graphPath;
+    std::vector<fs::path> files;
+    fs::path outputDir;
+    std::string scratchDir;
+    bool memoryReport = false;
+    unsigned inFlight = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outputDir = argv[++i];
+        } else if (arg == "-j" && i + 1 < argc) {
+            inFlight = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--scratch" && i + 1 < argc) {
+            scratchDir = argv[++i];
+        } else if (arg == "--memory") {
+            memoryReport = true;
+        } else if (graphPath.empty()) {
+            graphPath = arg;
+        } else {
+            collectInputs(arg, files);
+        }
+    }
+    if (graphPath.empty() || outputDir.empty() || files.empty()) return usage();
+    {
+        std::map<std::string, fs::path> names;
+        for (const fs::path& file : files) {
+            auto clash = names.emplace(file.stem().string(), file);
+            if (!clash.second) {
+                std::cerr << clash.first->second.string() << " and " << file.string()
+                          << " would both be written as " << file.stem().string() << std::endl;
+                return 1;
+            }
+        }
+    }
+    inFlight = std::min<unsigned>(inFlight, static_cast<unsigned>(files.size()));
+
+    std::string graphText;
+    {
+        std::ifstream in(graphPath, std::ios::binary);
+        if (!in) {
+            std::cerr << "Cannot read " << graphPath << std::endl;
+            return 1;
+        }
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        graphText = contents.str();
+    }
+
+    NodeFactory factory;
+    std::vector<Pipeline> pipelines;
+    try {
+        for (unsigned i = 0; i < inFlight; i++) {
+            pipelines.push_back(instantiate(graphText, factory));
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << graphPath << ": " << ex.what() << std::endl;
+        return 1;
+    }
+    if (pipelines[0].sources.empty() || pipelines[0].sinks.empty()) {
+        std::cerr << graphPath << ": the graph needs a LoadImageNode and an OutputNode" << std::endl;
+        return 1;
+    }
+    fs::create_directories(outputDir);
+
+    // Consecutive images of the same size reuse the previous image's buffers
+    PooledMatAllocator::install();
+    if (!scratchDir.empty()) {
+        fs::create_directories(scratchDir);
+        ScratchFileAllocator::install(scratchDir);
+    }
+
+    // Images are spread over the pipelines; give each one an equal share of
+    // OpenCV's own threads instead of letting every filter grab all cores
+    cv::setNumThreads(std::max(1, cv::getNumberOfCPUs() / static_cast<int>(inFlight)));
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::atomic<size_t> failed{0};
+    std::mutex progressMutex;
+    std::condition_variable finished;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < inFlight; w++) {
+        workers.emplace_back([&, w] {
+            // Every image runs the graph once, so intermediates are handed from
+            // node to node, or never leave the tile they are made in, rather
+            // than kept for later edits
+            GraphExecutor executor;
+            executor.setInPlace(true);
+            executor.setTiled(true);
+            for (size_t i = next++; i < files.size(); i = next++) {
+                bool ok = false;
+                try {
+                    ok = processImage(pipelines[w], executor, files[i], outputDir);
+                } catch (const std::exception& ex) {
+                    std::cerr << files[i].string() << ": " << ex.what() << std::endl;
+                }
+                if (!ok) {
+                    std::cerr << "Failed: " << files[i].string() << std::endl;
+                    failed++;
+                }
+                if (++done == files.size()) {
+                    std::lock_guard<std::mutex> lock(progressMutex);
+                    finished.notify_all();
+                }
+            }
+        });
+    }
+
+    auto elapsedSeconds = [&] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    {
+        // Progress once a second until the last image is written
+        std::unique_lock<std::mutex> lock(progressMutex);
+        while (!finished.wait_for(lock, std::chrono::seconds(1), [&] { return done == files.size(); })) {
+            std::cerr << "\r" << done << "/" << files.size() << " images, "
+                      << static_cast<int>(done / elapsedSeconds()) << " images/s" << std::flush;
+        }
+    }
+    double seconds = elapsedSeconds();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::cerr << "\r" << files.size() << " images in " << seconds << " s, "
+              << files.size() / seconds << " images/s, " << failed << " failed" << std::endl;
+    std::cerr << "Buffer pool: " << static_cast<int>(PooledMatAllocator::instance().stats().hitRate() * 100)
+              << "% of allocations reused" << std::endl;
+
+    if (memoryReport) {
+        // Every pipeline is a copy of the same graph; report the worst copy of each node
+        std::vector<MemoryReport::Entry> report = MemoryReport::collect(pipelines[0].nodes);
+        for (size_t p = 1; p < pipelines.size(); p++) {
+            std::vector<MemoryReport::Entry> other = MemoryReport::collect(pipelines[p].nodes);
+            for (size_t i = 0; i < report.size(); i++) {
+                report[i].resultBytes = std::max(report[i].resultBytes, other[i].resultBytes);
+                report[i].cacheBytes = std::max(report[i].cacheBytes, other[i].cacheBytes);
+                report[i].lastPeakBytes = std::max(report[i].lastPeakBytes, other[i].lastPeakBytes);
+                report[i].highWaterBytes = std::max(report[i].highWaterBytes, other[i].highWaterBytes);
+            }
+        }
+        MemoryReport::print(std::cerr, report);
+    }
+    return failed == 0 ? 0 : 1;
+}
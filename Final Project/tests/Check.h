@@ -0,0 +1,36 @@
+#pragma once
+#include <iostream>
+
+// Checks for the headless tests. A failed check reports itself and the test
+// goes on, so one run lists every failure; main() returns checkResult().
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void checkFailed(const char* file, int line, const char* what) {
+    std::cerr << file << ":" << line << ": check failed: " << what << std::endl;
+    checkFailures()++;
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) checkFailed(__FILE__, __LINE__, #condition); \
+    } while (0)
+
+// Passes if statement throws exception, or a type derived from it
+#define CHECK_THROWS(statement, exception) \
+    do { \
+        bool thrown = false; \
+        try { \
+            statement; \
+        } catch (const exception&) { \
+            thrown = true; \
+        } \
+        if (!thrown) checkFailed(__FILE__, __LINE__, #statement " throws " #exception); \
+    } while (0)
+
+inline int checkResult() {
+    if (checkFailures() == 0) std::cerr << "All checks passed" << std::endl;
+    return checkFailures() == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "Check.h"
+#include "BrightnessContrastNode.h"
+#include "ConvolutionFilterNode.h"
+#include "GraphExecutor.h"
+#include "OutputNode.h"
+#include "ResultSlot.h"
+#include "blurnode.h"
+#include <memory>
+
+// A chain run tile by tile (nodebatch) or for a region only (a zoomed preview)
+// produces exactly the pixels of the same chain run whole.
+
+namespace {
+// Publishes a fixed image, in place of a LoadImageNode and its file
+class ImageSource : public Node {
+public:
+    ImageSource(int id, cv::Mat image) : Node(id, "Image"), image(std::move(image)) {}
+    void process() override { output.publish(Frame(image)); }
+    Frame getOutput() const override { return output.read(); }
+    const char* typeName() const override { return "ImageSource"; }
+
+private:
+    cv::Mat image;
+    ResultSlot<Frame> output;
+};
+
+// Source -> brightness/contrast -> blur -> sharpen -> output: a pointwise node
+// and two filters with halos of different widths
+struct Pipeline {
+    std::unique_ptr<ImageSource> source;
+    std::unique_ptr<BrightnessContrastNode> adjust = std::make_unique<BrightnessContrastNode>(2);
+    std::unique_ptr<BlurNode> blur = std::make_unique<BlurNode>(3);
+    std::unique_ptr<ConvolutionFilterNode> sharpen = std::make_unique<ConvolutionFilterNode>(4);
+    std::unique_ptr<OutputNode> output = std::make_unique<OutputNode>(5);
+
+    explicit Pipeline(const cv::Mat& image) : source(std::make_unique<ImageSource>(1, image)) {
+        adjust->params.brightness = 10.0f;
+        adjust->params.contrast = 1.2f;
+        blur->params.radius = 3;
+        sharpen->applyPreset(ConvolutionFilterNode::Preset::Sharpen);
+        adjust->setInput(0, source.get());
+        blur->setInput(0, adjust.get());
+        sharpen->setInput(0, blur.get());
+        output->setInput(0, sharpen.get());
+    }
+
+    std::vector<Node*> nodes() const { return {source.get(), adjust.get(), blur.get(), sharpen.get(), output.get()}; }
+    void evaluate(GraphExecutor& executor) { executor.evaluate(nodes(), {output.get()}); }
+};
+
+bool samePixels(const ImageView& a, const ImageView& b) {
+    return !a.empty() && a.size() == b.size() && a.type() == b.type() && cv::norm(a, b, cv::NORM_INF) == 0;
+}
+
+// Larger than a tile in both directions and not a multiple of one, so there
+// are inner tiles, edge tiles and clipped corner tiles
+cv::Mat testImage() {
+    cv::Mat image(300, 420, CV_8UC3);
+    cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+    return image;
+}
+
+void testTiledMatchesWhole(const cv::Mat& image, const Frame& expected) {
+    Pipeline tiled(image);
+    GraphExecutor executor;
+    executor.setInPlace(true);
+    executor.setTiled(true);
+    tiled.evaluate(executor);
+
+    CHECK(tiled.output->tileChain.size() == 3);  // the three filters ran as one chain
+    CHECK(samePixels(tiled.output->getOutput().view(), expected.view()));
+}
+
+void testRegionMatchesWhole(const cv::Mat& image, const Frame& expected) {
+    Pipeline zoomed(image);
+    GraphExecutor executor;
+
+    // Inside the image, then over its bottom right corner, where the filters
+    // extrapolate past the edge
+    for (cv::Rect view : {cv::Rect(150, 100, 90, 60), cv::Rect(380, 260, 100, 100)}) {
+        zoomed.output->viewRegion = view;
+        zoomed.evaluate(executor);
+
+        cv::Rect area = view & cv::Rect(0, 0, image.cols, image.rows);
+        Frame region = zoomed.output->getOutput();
+        CHECK(region.isRegion());
+        CHECK(region.area() == area);
+        CHECK(region.imageSize() == image.size());
+        CHECK(samePixels(region.view(), expected.view()(area)));
+        CHECK(zoomed.blur->getOutput().size().area() < image.size().area());  // only the part needed
+    }
+}
+}
+
+int main() {
+    cv::Mat image = testImage();
+    Pipeline whole(image);
+    GraphExecutor executor;
+    whole.evaluate(executor);
+    Frame expected = whole.output->getOutput();
+    CHECK(!expected.empty() && !expected.isRegion());
+
+    testTiledMatchesWhole(image, expected);
+    testRegionMatchesWhole(image, expected);
+    return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "Check.h"
+#include "BrightnessContrastNode.h"
+#include "ConvolutionFilterNode.h"
+#include "GraphSerializer.h"
+#include "LoadImageNode.h"
+#include "OutputNode.h"
+#include "blurnode.h"
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+// Both graph forms survive a save and load unchanged, damaged files are
+// rejected with std::runtime_error instead of being read past their end, and
+// values a node cannot use are replaced when they are loaded.
+
+namespace {
+// A chain that saves every kind of field: a string, ints, floats, a bool and a float list
+GraphSerializer::NodeList makeGraph() {
+    auto source = std::make_unique<LoadImageNode>(1);
+    source->params.filePath = "images/first image.png";
+    auto adjust = std::make_unique<BrightnessContrastNode>(2);
+    adjust->params.brightness = 12.5f;
+    adjust->params.contrast = 1.1f;
+    auto blur = std::make_unique<BlurNode>(3);
+    blur->params.radius = 7;
+    blur->params.directionalBlur = true;
+    blur->params.angle = 30.0f;
+    auto sharpen = std::make_unique<ConvolutionFilterNode>(4);
+    sharpen->applyPreset(ConvolutionFilterNode::Preset::Sharpen);
+    auto output = std::make_unique<OutputNode>(5);
+
+    adjust->setInput(0, source.get());
+    blur->setInput(0, adjust.get());
+    sharpen->setInput(0, blur.get());
+    output->setInput(0, sharpen.get());
+
+    GraphSerializer::NodeList nodes;
+    nodes.push_back(std::move(source));
+    nodes.push_back(std::move(adjust));
+    nodes.push_back(std::move(blur));
+    nodes.push_back(std::move(sharpen));
+    nodes.push_back(std::move(output));
+    return nodes;
+}
+
+std::vector<Node*> pointers(const GraphSerializer::NodeList& nodes) {
+    std::vector<Node*> result;
+    for (const auto& node : nodes) result.push_back(node.get());
+    return result;
+}
+
+std::string saveText(const GraphSerializer::NodeList& nodes) {
+    std::ostringstream out;
+    GraphSerializer::saveText(out, pointers(nodes));
+    return out.str();
+}
+
+std::string saveBinary(const GraphSerializer::NodeList& nodes) {
+    std::ostringstream out;
+    GraphSerializer::saveBinary(out, pointers(nodes));
+    return out.str();
+}
+
+GraphSerializer::NodeList loadText(const std::string& text, const NodeFactory& factory) {
+    std::istringstream in(text);
+    return GraphSerializer::loadText(in, factory);
+}
+
+GraphSerializer::NodeList loadBinary(const std::string& data, const NodeFactory& factory) {
+    return GraphSerializer::loadBinary(data.data(), data.size(), factory);
+}
+
+void testRoundTrips(const NodeFactory& factory) {
+    GraphSerializer::NodeList graph = makeGraph();
+    std::string text = saveText(graph);
+    std::string binary = saveBinary(graph);
+
+    GraphSerializer::NodeList fromText = loadText(text, factory);
+    CHECK(saveText(fromText) == text);
+    CHECK(saveBinary(fromText) == binary);
+
+    GraphSerializer::NodeList fromBinary = loadBinary(binary, factory);
+    CHECK(saveBinary(fromBinary) == binary);
+    CHECK(saveText(fromBinary) == text);
+
+    // The values and the wiring themselves, not just their text
+    CHECK(fromBinary.size() == graph.size());
+    if (fromBinary.size() == graph.size()) {
+        auto* source = dynamic_cast<LoadImageNode*>(fromBinary[0].get());
+        auto* blur = dynamic_cast<BlurNode*>(fromBinary[2].get());
+        auto* sharpen = dynamic_cast<ConvolutionFilterNode*>(fromBinary[3].get());
+        CHECK(source && source->params.filePath == "images/first image.png");
+        CHECK(blur && blur->params.radius == 7 && blur->params.directionalBlur && blur->params.angle == 30.0f);
+        CHECK(sharpen && sharpen->params.kernel == std::vector<float>({0, -1, 0, -1, 5, -1, 0, -1, 0}));
+        CHECK(fromBinary[4]->inputs[0] == fromBinary[3].get());
+        CHECK(fromBinary[1]->inputs[0] == fromBinary[0].get());
+    }
+
+    // load() tells the forms apart
+    std::istringstream textStream(text), binaryStream(binary);
+    CHECK(GraphSerializer::load(textStream, factory).size() == graph.size());
+    CHECK(GraphSerializer::load(binaryStream, factory).size() == graph.size());
+}
+
+void testDamagedFiles(const NodeFactory& factory) {
+    GraphSerializer::NodeList graph = makeGraph();
+    std::string text = saveText(graph);
+    std::string binary = saveBinary(graph);
+
+    // Every binary file cut short is reported, wherever the cut falls
+    for (size_t length = 0; length < binary.size(); length++) {
+        CHECK_THROWS(loadBinary(binary.substr(0, length), factory), std::runtime_error);
+    }
+
+    // A float list count beyond the end of the file. The field is stored as
+    // its name (length, then characters), a tag byte, then the count.
+    uint32_t nameLength = 6;
+    std::string name = std::string(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength)) + "kernel";
+    size_t field = binary.find(name);
+    CHECK(field != std::string::npos);
+    if (field != std::string::npos) {
+        std::string corrupt = binary;
+        uint32_t count = 0xffffffffu;
+        std::memcpy(&corrupt[field + name.size() + 1], &count, sizeof(count));
+        CHECK_THROWS(loadBinary(corrupt, factory), std::runtime_error);
+    }
+
+    // A text file cut inside a float list
+    size_t line = text.find("param 4 kernel 9 ");
+    CHECK(line != std::string::npos);
+    if (line != std::string::npos) {
+        std::string cut = text.substr(0, line + std::strlen("param 4 kernel 9 0 -1"));
+        CHECK_THROWS(loadText(cut, factory), std::runtime_error);
+
+        // Counts the line cannot hold are rejected before anything is allocated
+        for (const char* count : {"10", "4000000000", "18446744073709551615", "-1"}) {
+            std::string corrupt = text;
+            corrupt.replace(line, std::strlen("param 4 kernel 9"), std::string("param 4 kernel ") + count);
+            CHECK_THROWS(loadText(corrupt, factory), std::runtime_error);
+        }
+    }
+}
+
+// text with the value of a parameter line replaced
+std::string withParam(std::string text, const std::string& param, const std::string& value) {
+    size_t line = text.find(param + ' ');
+    CHECK(line != std::string::npos);
+    if (line == std::string::npos) return text;
+    size_t start = line + param.size() + 1;
+    text.replace(start, text.find('\n', start) - start, value);
+    return text;
+}
+
+ConvolutionFilterNode* loadKernel(const std::string& text, const NodeFactory& factory,
+                                  GraphSerializer::NodeList& nodes) {
+    nodes = loadText(text, factory);
+    return nodes.size() > 3 ? dynamic_cast<ConvolutionFilterNode*>(nodes[3].get()) : nullptr;
+}
+
+void testInvalidKernels(const NodeFactory& factory) {
+    std::string text = saveText(makeGraph());
+    GraphSerializer::NodeList nodes;
+
+    // A 5x5 kernel with the values of a 3x3 one becomes the 5x5 identity
+    ConvolutionFilterNode* sharpen = loadKernel(withParam(text, "param 4 kernelSize", "5"), factory, nodes);
+    CHECK(sharpen && sharpen->params.kernelSize == 5);
+    if (sharpen && sharpen->params.kernelSize == 5) {
+        std::vector<float> identity(25, 0.0f);
+        identity[12] = 1.0f;
+        CHECK(sharpen->params.kernel == identity);
+        CHECK(sharpen->params.kernelDivisor == 1.0f);
+    }
+
+    // Sizes other than 3 and 5 become the nearer of them
+    for (const char* size : {"0", "-3", "1000"}) {
+        sharpen = loadKernel(withParam(text, "param 4 kernelSize", size), factory, nodes);
+        CHECK(sharpen && (sharpen->params.kernelSize == 3 || sharpen->params.kernelSize == 5));
+        if (sharpen) {
+            size_t values = sharpen->params.kernelSize * sharpen->params.kernelSize;
+            CHECK(sharpen->params.kernel.size() == values);
+        }
+    }
+
+    // A zero divisor keeps the kernel and divides by 1
+    sharpen = loadKernel(withParam(text, "param 4 kernelDivisor", "0"), factory, nodes);
+    CHECK(sharpen && sharpen->params.kernelDivisor == 1.0f);
+    CHECK(sharpen && sharpen->params.kernel == std::vector<float>({0, -1, 0, -1, 5, -1, 0, -1, 0}));
+}
+}
+
+int main() {
+    NodeFactory factory;
+    testRoundTrips(factory);
+    testDamagedFiles(factory);
+    testInvalidKernels(factory);
+    return checkResult();
+}
\ No newline at end of file